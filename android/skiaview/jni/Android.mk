@@ -30,6 +30,9 @@ LOCAL_SRC_FILES  := GiSkiaView.cpp \
                     $(SRC_PATH)/geom/mgmat.cpp \
                     $(SRC_PATH)/geom/mgbase.cpp \
                     $(SRC_PATH)/geom/mgbnd.cpp \
+                    $(SRC_PATH)/geom/mgarclen.cpp \
+                    $(SRC_PATH)/geom/mgbatch.cpp \
+                    $(SRC_PATH)/geom/mgcross.cpp \
                     $(SRC_PATH)/geom/mgbox.cpp \
                     $(SRC_PATH)/geom/mgcurv.cpp \
                     $(SRC_PATH)/geom/mglnrel.cpp \
@@ -37,6 +40,9 @@ LOCAL_SRC_FILES  := GiSkiaView.cpp \
                     $(SRC_PATH)/geom/mgnearbz.cpp \
                     $(SRC_PATH)/geom/mgvec.cpp \
                     $(SRC_PATH)/graph/gipath.cpp \
+                    $(SRC_PATH)/graph/giraster.cpp \
+                    $(SRC_PATH)/graph/giparallel.cpp \
+                    $(SRC_PATH)/graph/gitiles.cpp \
                     $(SRC_PATH)/graph/gixform.cpp \
                     $(SRC_PATH)/graph/gigraph.cpp \
                     $(SRC_PATH)/shape/mgcmddraw.cpp \
@@ -54,6 +60,13 @@ LOCAL_SRC_FILES  := GiSkiaView.cpp \
                     $(SRC_PATH)/shape/mgellipse.cpp \
                     $(SRC_PATH)/shape/mgline.cpp \
                     $(SRC_PATH)/shape/mglines.cpp \
+                    $(SRC_PATH)/shape/mglod.cpp \
+                    $(SRC_PATH)/shape/mgsorter.cpp \
+                    $(SRC_PATH)/shape/mgocclude.cpp \
+                    $(SRC_PATH)/shape/mgsegtree.cpp \
+                    $(SRC_PATH)/shape/mgpick.cpp \
+                    $(SRC_PATH)/shape/mgprogress.cpp \
+                    $(SRC_PATH)/shape/mgstyle.cpp \
                     $(SRC_PATH)/shape/mgrdrect.cpp \
                     $(SRC_PATH)/shape/mgrect.cpp \
                     $(SRC_PATH)/shape/mggrid.cpp \
@@ -7,8 +7,11 @@
 #include <list>
 #include <mgstoragebs.h>
 #include <mgcmd.h>
+#include <mgpick.h>
 #include <vector>
 
+static void onShapesLocked(MgShapes* sp, void* obj, bool locked);
+
 //! 绘图视图代理类
 /*! \ingroup GRAPH_SKIA
     \see GiSkiaView
@@ -21,16 +24,20 @@ public:
     MgMotion        _motion;        //!< 当前触摸参数
     bool            _moved;         //!< 是否开始移动
     GiContext       _tmpContext;    //!< 临时绘图参数，用于避免applyContext引用参数问题
+    MgPickBuffer*   _picker;        //!< 点选图形的网格缓冲，显示后刷新，默认为NULL即遍历图形点选
 
-    MgViewProxy(GiCanvasBase* canvas) : _canvas(canvas), _moved(false) {
+    MgViewProxy(GiCanvasBase* canvas) : _canvas(canvas), _moved(false), _picker(NULL) {
         _shapes = new MgShapesT<std::list<MgShape*> >;
         _motion.view = this;
         _shapes->context()->setLineAlpha(140);  // 默认55%透明度
         _shapes->context()->setAutoFillColor(true);
+        MgShapesLock::registerObserver(onShapesLocked, this);
     }
     virtual ~MgViewProxy() {
+        MgShapesLock::unregisterObserver(onShapesLocked, this);
         mgGetCommandManager()->unloadCommands();
         _shapes->release();
+        delete _picker;
     }
 
     virtual MgShapes* shapes() {
@@ -42,20 +49,42 @@ public:
     virtual GiGraphics* graph() {
         return &_canvas->gs();
     }
+    virtual MgPickBuffer* pickBuffer() {
+        return _picker;
+    }
     virtual void regen() {
+        invalidatePicker();
         _canvas->clearCachedBitmap();
         _canvas->setNeedRedraw();
     }
     virtual void redraw(bool) {
         _canvas->setNeedRedraw();
     }
+    void invalidatePicker() {
+        if (_picker)
+            _picker->invalidate();
+    }
+    void shapesChanged() {                      // 修改图形后解锁时调用
+        invalidatePicker();
+        _canvas->clearCachedBitmap();
+        _canvas->setNeedRedraw();
+    }
     virtual bool drawHandle(GiGraphics* gs, const Point2d& pnt, bool hotdot) {
     	Point2d ptd(pnt * gs->xf().modelToDisplay());
     	return _canvas->drawHandle(ptd.x, ptd.y, hotdot ? 1 : 0);
     }
 };
 
-GiSkiaView::GiSkiaView(GiCanvasBase* canvas) : _zoomMask(7)
+static void onShapesLocked(MgShapes* sp, void* obj, bool locked)
+{
+    MgViewProxy* view = (MgViewProxy*)obj;
+    
+    if (!locked && sp == view->_shapes) {
+        view->shapesChanged();
+    }
+}
+
+GiSkiaView::GiSkiaView(GiCanvasBase* canvas) : _zoomMask(7), _previewing(false)
 {
     _view = new MgViewProxy(canvas);
 }
@@ -115,7 +144,13 @@ void GiSkiaView::onSize(int width, int height)
 
 bool GiSkiaView::onDraw(GiCanvasBase& canvas)
 {
-    return _view->_shapes && _view->_shapes->draw(canvas.gs()) > 0;
+    _drawnM2D = canvas.xf().modelToDisplay();
+    bool ret = _view->_shapes && _view->_shapes->draw(canvas.gs()) > 0;
+
+    if (_view->_picker && !_view->_motion.dragging) {   // 显示后刷新点选缓冲，拖动和放缩时不刷新
+        _view->_picker->update(_view->_shapes, canvas.xf());
+    }
+    return ret;
 }
 
 bool GiSkiaView::onDynDraw(GiCanvasBase& canvas)
@@ -147,6 +182,7 @@ bool GiSkiaView::onGesture(GiGestureType gestureType, GiGestureState gestureStat
     		&& gestureState == kGestureMoved);
     if (gestureState == kGestureCancel
         && (kSinglePan == gestureType || kZoomRotatePan == gestureType)) {
+        endZoomPreview();
         return cmd->cancel(&_view->_motion);
     }
 
@@ -209,7 +245,7 @@ GiContext& GiSkiaView::getCurrentContext(bool forChange)
 {
     MgShape* shape = NULL;
     mgGetCommandManager()->getSelection(_view, 1, &shape, forChange);
-    _view->_tmpContext = shape ? *shape->context() : *_view->context();
+    _view->_tmpContext = shape ? *shape->contextc() : *_view->context();
     return _view->_tmpContext;
 }
 
@@ -222,7 +258,9 @@ void GiSkiaView::applyContext(const GiContext& ctx, int mask, int apply)
         if (n > 0 && mgGetCommandManager()->getSelection(_view, n, (MgShape**)&shapes.front(), true) > 0) {
             for (UInt32 i = 0; i < n; i++) {
                 if (shapes[i]) {
-                    shapes[i]->context()->copy(ctx, mask);
+                    GiContext tmpctx(*shapes[i]->contextc());
+                    tmpctx.copy(ctx, mask);
+                    shapes[i]->setContext(tmpctx);
                 }
             }
             _view->redraw(false);
@@ -240,6 +278,52 @@ void GiSkiaView::applyContext(const GiContext& ctx, int mask, int apply)
 void GiSkiaView::setZoomFeature(int mask)
 {
     _zoomMask = mask;
+    if (!(mask & 8)) {
+        endZoomPreview();
+    }
+}
+
+void GiSkiaView::setPickBuffer(bool enable)
+{
+    if (!enable) {
+        delete _view->_picker;
+        _view->_picker = NULL;
+    }
+    else if (!_view->_picker) {
+        _view->_picker = new MgPickBuffer();
+        _view->_canvas->setNeedRedraw();        // 在下次显示后生成
+    }
+}
+
+bool GiSkiaView::isZoomPreview() const
+{
+    return _previewing;
+}
+
+bool GiSkiaView::getZoomPreviewMatrix(mgvector<float>& mat) const
+{
+    if (!_previewing || mat.count() < 6) {
+        return false;
+    }
+    
+    Matrix2d m(_drawnM2D.inverse() * _view->_canvas->xf().modelToDisplay());
+    
+    mat.set(0, m.m11);
+    mat.set(1, m.m12);
+    mat.set(2, m.m21);
+    mat.set(3, m.m22);
+    mat.set(4, m.dx);
+    mat.set(5, m.dy);
+    
+    return true;
+}
+
+void GiSkiaView::endZoomPreview()
+{
+    if (_previewing) {
+        _previewing = false;
+        _view->regen();
+    }
 }
 
 bool GiSkiaView::dynZoom(const Point2d& pt1, const Point2d& pt2, int gestureState)
@@ -257,7 +341,16 @@ bool GiSkiaView::dynZoom(const Point2d& pt1, const Point2d& pt2, int gestureStat
         _view->_canvas->xf().zoomByFactor(scale - 1, &_firstPt);        // 以起始点为中心放缩显示
         _view->_canvas->xf().zoomPan(pt.x - _firstPt.x, pt.y - _firstPt.y); // 平移到当前点
 
-        _view->regen();
+        if (_zoomMask & 8) {                    // 预览快照，手势结束或暂停后再完整显示
+            _previewing = true;
+            _view->redraw(false);
+        }
+        else {
+            _view->regen();
+        }
+    }
+    else if (kGestureEnded == gestureState) {
+        endZoomPreview();
     }
 
     return true;
@@ -104,9 +104,32 @@ public:
      */
     void applyContext(const GiContext& ctx, int mask, int apply);
     
-    //! 设置允许的放缩类型: 0-禁止, 1-平移, 2-缩放, 4-局部放大和还原, 7-全部
+    //! 设置允许的放缩类型: 0-禁止, 1-平移, 2-缩放, 4-局部放大和还原, 7-全部, 8-动态放缩时预览快照
     void setZoomFeature(int mask);
     
+    //! 设置是否用网格缓冲点选图形，默认不用，点选时遍历图形
+    /** 修改图形后的下一次显示要在网格位图上重新显示整个文档，图形很多时会使显示明显卡顿，
+     * 而点选只是略快，因此只适合图形很多、很少修改而点选频繁的场合。
+     * \see MgPickBuffer
+     */
+    void setPickBuffer(bool enable);
+    
+    //! 返回是否正在动态放缩预览
+    /** 预览时不需要调用 onDraw 重新显示图形，而是按 getZoomPreviewMatrix 变换显示上次完整显示的快照，
+     * 只在 setZoomFeature 设置了8时才会预览
+     */
+    bool isZoomPreview() const;
+    
+    //! 得到从上次完整显示到当前显示的变换矩阵
+    /**
+     * \param mat 输出6个元素(a, b, c, d, tx, ty)，快照上的点(x, y)显示到(a*x + c*y + tx, b*x + d*y + ty)
+     * \return 是否正在动态放缩预览
+     */
+    bool getZoomPreviewMatrix(mgvector<float>& mat) const;
+    
+    //! 结束动态放缩预览并请求完整显示，在手势结束或暂停时调用
+    void endZoomPreview();
+    
 private:
     bool dynZoom(const Point2d& pt1, const Point2d& pt2, int gestureState);
     bool switchZoom(const Point2d& pt);
@@ -118,6 +141,8 @@ private:
     float               _lastViewScale;
     Point2d             _firstPt;
     float               _firstDist;
+    Matrix2d            _drawnM2D;      //!< 上次完整显示时的模型坐标到显示坐标的变换
+    bool                _previewing;    //!< 是否正在动态放缩预览
 };
 
 #endif // __TOUCHVG_SKIAVIEW_H_
@@ -1,6 +1,7 @@
 ﻿package touchvg.view;
 
 import java.io.ByteArrayOutputStream;
+import touchvg.skiaview.Floats;
 import touchvg.skiaview.GiColor;
 import touchvg.skiaview.GiSkiaView;
 import touchvg.skiaview.GiGestureState;
@@ -9,6 +10,8 @@ import android.content.Context;
 import android.graphics.Bitmap;
 import android.graphics.Canvas;
 import android.graphics.Color;
+import android.graphics.Matrix;
+import android.graphics.Paint;
 import android.graphics.drawable.BitmapDrawable;
 import android.util.AttributeSet;
 import android.util.DisplayMetrics;
@@ -34,6 +37,18 @@ public class PaintView extends View {
     private int mBmpIds[] = { 0, 0, 0, 0, 0 };
     private Bitmap mBmps[] = { null, null, null, null, null };
     private final PaintView mView = this;
+    private boolean mZoomPreview = false;
+    private Bitmap mSnapshot = null;
+    private Canvas mSnapshotCanvas = null;
+    private final Floats mPreviewValues = new Floats(6);
+    private final Matrix mPreviewMatrix = new Matrix();
+    private final float[] mPreviewMatValues = { 1, 0, 0, 0, 1, 0, 0, 0, 1 };   // 末行不变，只填前两行
+    private final Paint mPreviewPaint = new Paint(Paint.FILTER_BITMAP_FLAG);
+    private final Runnable mEndPreview = new Runnable() {
+        public void run() {
+            mCore.endZoomPreview();
+        }
+    };
     
     static {
         System.loadLibrary("skiaview");
@@ -130,7 +145,10 @@ public class PaintView extends View {
     protected void onDraw(Canvas canvas) {
         mCore.onSize(canvas.getWidth(), canvas.getHeight());
         
-        if (mCanvas.beginPaint(canvas)) {
+        if (mZoomPreview) {
+            drawWithSnapshot(canvas);
+        }
+        else if (mCanvas.beginPaint(canvas)) {
             canvas.drawColor(mBkColor);
             mCore.onDraw(mCanvas);
             mCore.onDynDraw(mCanvas);
@@ -138,6 +156,51 @@ public class PaintView extends View {
         }
     }
     
+    // 设置动态放缩时是否显示缩放的快照，图形很多时可保持流畅
+    public void setZoomPreview(boolean enable) {
+        mZoomPreview = enable;
+        mCore.setZoomFeature(enable ? 15 : 7);
+        if (!enable) {
+            mSnapshot = null;
+            mSnapshotCanvas = null;
+        }
+    }
+    
+    private void drawWithSnapshot(Canvas canvas) {
+        if (mSnapshot != null && mCore.getZoomPreviewMatrix(mPreviewValues)) {
+            mPreviewMatValues[0] = mPreviewValues.get(0);
+            mPreviewMatValues[1] = mPreviewValues.get(2);
+            mPreviewMatValues[2] = mPreviewValues.get(4);
+            mPreviewMatValues[3] = mPreviewValues.get(1);
+            mPreviewMatValues[4] = mPreviewValues.get(3);
+            mPreviewMatValues[5] = mPreviewValues.get(5);
+            mPreviewMatrix.setValues(mPreviewMatValues);
+            canvas.drawColor(mBkColor);
+            canvas.drawBitmap(mSnapshot, mPreviewMatrix, mPreviewPaint);
+            removeCallbacks(mEndPreview);
+            postDelayed(mEndPreview, 300);      // 手势暂停后完整显示
+        }
+        else {
+            int w = canvas.getWidth();
+            int h = canvas.getHeight();
+            
+            if (mSnapshot == null || mSnapshot.getWidth() != w || mSnapshot.getHeight() != h) {
+                mSnapshot = Bitmap.createBitmap(w, h, Bitmap.Config.ARGB_8888);
+                mSnapshotCanvas = new Canvas(mSnapshot);
+            }
+            mSnapshot.eraseColor(mBkColor);
+            if (mCanvas.beginPaint(mSnapshotCanvas)) {  // 完整显示到快照上
+                mCore.onDraw(mCanvas);
+                mCanvas.endPaint();
+            }
+            canvas.drawBitmap(mSnapshot, 0, 0, null);
+        }
+        if (mCanvas.beginPaint(canvas)) {
+            mCore.onDynDraw(mCanvas);
+            mCanvas.endPaint();
+        }
+    }
+    
     public void setGestureEnable(boolean enable) {
         mGestureEnable = enable;
         
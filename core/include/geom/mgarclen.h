@@ -0,0 +1,84 @@
+//! \file mgarclen.h
+//! \brief 定义折线和多段贝塞尔曲线的弧长表类 MgArcLength
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+
+#ifndef __GEOMETRY_MGARCLEN_H_
+#define __GEOMETRY_MGARCLEN_H_
+
+#include "mgbox.h"
+
+//! 折线和多段贝塞尔曲线的弧长表类
+/*! 记录各采样点的参数和从起点开始的累计弧长，参数的整数部分为段号，小数部分为段内参数。
+    贝塞尔曲线段按弯曲程度和参数速度的变化自适应采样，直线段只需记录顶点。\n
+    生成后按参数求弧长和按弧长求参数都只需二分查找后在相邻采样点间插值，
+    适合测量笔画长度、按弧长布置线型和等距重新采样，不必每次重新离散曲线。
+    \ingroup GEOM_CLASS
+    \see MgSplines::getArcLength
+*/
+class MgArcLength
+{
+public:
+    MgArcLength();
+    ~MgArcLength();
+
+    //! 由折线生成，各顶点为采样点
+    /*!
+        \param count 顶点数
+        \param points 顶点数组
+        \param closed 是否闭合，闭合时末段从最后一个顶点到第一个顶点
+    */
+    void buildLines(Int32 count, const Point2d* points, bool closed);
+
+    //! 由首尾相接的多段三次贝塞尔曲线生成
+    /*!
+        \param count 控制点数，为 3n+1，n为曲线段数
+        \param points 控制点数组
+        \param tol 弧长误差，每个采样区间的控制多边形长度与弦长之差、前后两半的弧长之差都不超过该值
+    */
+    void buildBeziers(Int32 count, const Point2d* points, float tol);
+
+    //! 清除弧长表
+    void clear();
+
+    //! 返回段数，参数范围为 [0, 段数]
+    Int32 getSegmentCount() const { return _segments; }
+
+    //! 返回采样点数
+    Int32 getSampleCount() const { return _count; }
+
+    //! 返回总长度
+    float getLength() const { return _count > 0 ? _lengths[_count - 1] : 0.f; }
+
+    //! 返回从起点到给定参数处的弧长，参数超出范围时取端点
+    float lengthAt(float t) const;
+
+    //! 返回从起点开始的弧长为给定值处的参数，弧长超出范围时取端点
+    float paramAt(float length) const;
+
+    //! 将参数分解为段号和段内参数
+    /*!
+        \param t 参数，范围为 [0, 段数]
+        \param u 输出段内参数，范围为 [0, 1]
+        \return 段号，末端点处返回最后一段
+    */
+    Int32 splitParam(float t, float& u) const;
+
+private:
+    enum { MAX_DEPTH = 12 };        //!< 每段曲线的最大细分层数
+
+    void addSample(float t, float length);
+    void addBezier(Int32 segment, const Point2d* pts, float t0, float t1,
+                   float len, float tol, int depth);
+
+    Int32   _segments;              //!< 段数
+    Int32   _count;                 //!< 采样点数
+    Int32   _capacity;              //!< 数组容量
+    float*  _params;                //!< 各采样点的参数，从小到大排列
+    float*  _lengths;               //!< 各采样点处的累计弧长
+
+    MgArcLength(const MgArcLength&);
+    void operator=(const MgArcLength&);
+};
+
+#endif // __GEOMETRY_MGARCLEN_H_
@@ -0,0 +1,30 @@
+//! \file mgbatch.h
+//! \brief 定义成批计算绑定框的函数
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+
+#ifndef __GEOMETRY_MGBATCH_H_
+#define __GEOMETRY_MGBATCH_H_
+
+#include "mgbox.h"
+
+//! 计算点数组的坐标范围
+/*! 与 Box2d(count, points) 不同，只求坐标的最小值和最大值，不会扩大宽或高为零的框。
+    在支持SSE2的平台上每次处理两个点，其余平台逐点比较。
+    \ingroup GEOMAPI_LNREL
+    \param[in] count 点数，小于1时输出空框
+    \param[in] points 点数组
+    \param[out] box 坐标范围
+*/
+GEOMAPI void mgPointsBox(Int32 count, const Point2d* points, Box2d& box);
+
+//! 计算折线各段的绑定框
+/*!
+    \ingroup GEOMAPI_LNREL
+    \param[in] count 折线顶点数，段数为 count-1
+    \param[in] points 折线顶点数组
+    \param[out] boxes 各段的绑定框数组，元素个数为 count-1，宽或高可能为零
+*/
+GEOMAPI void mgLineBoxes(Int32 count, const Point2d* points, Box2d* boxes);
+
+#endif // __GEOMETRY_MGBATCH_H_
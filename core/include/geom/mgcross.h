@@ -0,0 +1,92 @@
+//! \file mgcross.h
+//! \brief 定义线段集合求交的网格索引类 MgCrossGrid
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+
+#ifndef __GEOMETRY_MGCROSS_H_
+#define __GEOMETRY_MGCROSS_H_
+
+#include "mgbox.h"
+
+//! 找到一个交点时的回调函数
+/*!
+    \param data 调用者传入的数据
+    \param seg1 第一条线段的序号
+    \param seg2 第二条线段的序号，与给定线段求交时为-1
+    \param pt 交点
+    \return 是否继续查找
+    \see MgCrossGrid
+*/
+typedef bool (*MgCrossFound)(void* data, Int32 seg1, Int32 seg2, const Point2d& pt);
+
+//! 线段集合求交的网格索引类
+/*! 将线段集合的范围分为约与线段数相同个数的均匀网格，每个网格记录穿过它的线段，
+    求交时只对同一网格中的线段用 mgCross2Line 求交点，并用标记避免重复测试同一对线段。
+    线段分布较均匀时计算量接近 O(n+k)，k为交点数，不必测试所有线段对。\n
+    可一次求出所有线段两两之间的交点，也可求任意一条线段与集合中各线段的交点，
+    例如图形不变而拖动的线段不断变化时只需生成一次网格。
+    \ingroup GEOM_CLASS
+    \see mgCross2Line
+*/
+class MgCrossGrid
+{
+public:
+    MgCrossGrid();
+    ~MgCrossGrid();
+
+    //! 由线段集合生成网格
+    /*!
+        \param count 线段数
+        \param pts 线段端点数组，元素个数为 count*2，第i条线段为 pts[2*i] 和 pts[2*i+1]
+    */
+    void build(Int32 count, const Point2d* pts);
+
+    //! 清除线段集合和网格
+    void clear();
+
+    //! 返回线段数
+    Int32 getCount() const { return _count; }
+
+    //! 返回线段集合的范围
+    const Box2d& getExtent() const { return _extent; }
+
+    //! 求所有线段两两之间的交点，不含端点处的交点
+    /*!
+        \param found 找到交点时的回调函数，seg1小于seg2
+        \param data 传给回调函数的数据
+        \return 找到的交点数
+    */
+    Int32 findAll(MgCrossFound found, void* data) const;
+
+    //! 求给定线段与集合中各线段的交点，不含端点处的交点
+    /*!
+        \param a 给定线段的起点
+        \param b 给定线段的终点
+        \param found 找到交点时的回调函数，seg1为集合中线段的序号，seg2为-1
+        \param data 传给回调函数的数据
+        \return 找到的交点数
+    */
+    Int32 findCross(const Point2d& a, const Point2d& b,
+                    MgCrossFound found, void* data) const;
+
+private:
+    enum { MAX_CELLS = 512 };       //!< 每个方向的最多网格数
+
+    template <class Op> void walk(const Point2d& a, const Point2d& b, Op& op) const;
+    Int32 nextMark() const;
+
+    Int32       _count;             //!< 线段数
+    Point2d*    _pts;               //!< 线段端点，元素个数为 _count*2
+    Box2d       _extent;            //!< 线段集合的范围
+    Int32       _nx, _ny;           //!< X和Y方向的网格数
+    float       _cw, _ch;           //!< 网格的宽和高
+    Int32*      _cellStart;         //!< 各网格的线段在 _cellSegs 中的起始位置，元素个数为 _nx*_ny+1
+    Int32*      _cellSegs;          //!< 各网格中的线段序号
+    Int32*      _marks;             //!< 各线段最近一次测试时的标记
+    mutable Int32 _mark;            //!< 当前标记
+
+    MgCrossGrid(const MgCrossGrid&);
+    void operator=(const MgCrossGrid&);
+};
+
+#endif // __GEOMETRY_MGCROSS_H_
@@ -160,11 +160,35 @@ GEOMAPI bool mgArcBulge(
     \param[in] c 系数矩阵中的右对角线元素数组，c[0..n-2]
     \param[in,out] vs 输入方程组等号右边的已知n个矢量，输出求解出的未知矢量
     \return 是否求解成功，失败原因可能是参数错误或因系数矩阵非主角占优而出现除零
-    \see mgGaussJordan
+    \see mgCyclicTriEquations, mgGaussJordan
 */
 GEOMAPI bool mgTriEquations(
     Int32 n, float *a, float *b, float *c, Vector2d *vs);
 
+//! 求解循环三对角线方程组
+/*! 循环三对角线方程组如下所示，用 Sherman-Morrison 公式化为两个三对角线方程组求解，
+    时间和内存都是O(n): \n
+    　　　| b0　　　c0　　　　　　beta | \n
+    A　=　| a0　　　b1　　　c1　　　　 | \n
+    　　　|　　..　　　..　　.. 　　　 | \n
+    　　　| alpha　　a[n-2]　　b[n-1]　| \n
+    A * (x,y) = (rx,ry)
+
+    \ingroup GEOMAPI_BASIC
+    \param[in] n 方程组阶数，最小为3
+    \param[in] a 系数矩阵中的左对角线元素数组，a[0..n-2]
+    \param[in] b 系数矩阵中的中对角线元素数组，b[0..n-1]
+    \param[in] c 系数矩阵中的右对角线元素数组，c[0..n-2]
+    \param[in] alpha 系数矩阵左下角的元素
+    \param[in] beta 系数矩阵右上角的元素
+    \param[in,out] vs 输入方程组等号右边的已知n个矢量，输出求解出的未知矢量
+    \return 是否求解成功，失败原因可能是参数错误或因系数矩阵非主角占优而出现除零
+    \see mgTriEquations, mgCubicSplines
+*/
+GEOMAPI bool mgCyclicTriEquations(
+    Int32 n, const float *a, const float *b, const float *c,
+    float alpha, float beta, Vector2d *vs);
+
 //! Gauss-Jordan法求解线性方程组
 /*!
     \ingroup GEOMAPI_BASIC
@@ -253,6 +277,98 @@ GEOMAPI void mgCubicSplineToBezier(
 GEOMAPI Int32 mgBSplinesToBeziers(
     Point2d points[/*1+n*3*/], Int32 n, const Point2d* ctlpts, bool closed);
 
+//! 计算三次贝塞尔曲线段转换为折线所需的分段数
+/*! 按 Wang 公式由控制点的二阶差分估计，使等参数分段的折线与曲线的距离不超过容差
+    \ingroup GEOMAPI_CURVE
+    \param[in] pts 4个点的数组，为贝塞尔曲线段的控制点
+    \param[in] tol 折线与曲线的最大允许距离，例如显示时取0.25像素
+    \return 分段数，在1到1024之间
+    \see mgBeziersToLines
+*/
+GEOMAPI Int32 mgBezierSegments(const Point2d* pts, float tol);
+
+//! 将多段三次贝塞尔曲线转换为折线
+/*! 每段曲线按 mgBezierSegments 得到的分段数用前向差分法计算等参数点，
+    计算量与输出的顶点数成正比。
+    \ingroup GEOMAPI_CURVE
+    \param[out] pxs 折线顶点数组，为NULL时只计算顶点个数
+    \param[in] maxCount pxs的元素个数，超出时不输出多余的顶点
+    \param[in] count 贝塞尔曲线的控制点数，为3n+1
+    \param[in] pts 贝塞尔曲线的控制点数组，首尾相接
+    \param[in] tol 折线与曲线的最大允许距离
+    \return 折线的全部顶点个数，可能大于maxCount
+    \see mgBezierSegments, mgCubicSplinesToLines
+*/
+GEOMAPI Int32 mgBeziersToLines(
+    Point2d* pxs, Int32 maxCount, Int32 count, const Point2d* pts, float tol);
+
+//! 将三次样条曲线转换为折线
+/*!
+    \ingroup GEOMAPI_CURVE
+    \param[out] pxs 折线顶点数组，为NULL时只计算顶点个数
+    \param[in] maxCount pxs的元素个数，超出时不输出多余的顶点
+    \param[in] n 三次样条曲线的型值点的点数
+    \param[in] knots 型值点坐标数组，元素个数为n
+    \param[in] knotvs 型值点的切矢量数组，元素个数为n
+    \param[in] closed 是否为闭合曲线，闭合时最后一个顶点与第一个顶点重合
+    \param[in] tol 折线与曲线的最大允许距离
+    \return 折线的全部顶点个数，可能大于maxCount
+    \see mgCubicSplines, mgBeziersToLines
+*/
+GEOMAPI Int32 mgCubicSplinesToLines(
+    Point2d* pxs, Int32 maxCount, Int32 n, const Point2d* knots,
+    const Vector2d* knotvs, bool closed, float tol);
+
+//! 用最少的三次贝塞尔曲线段拟合一系列点
+/*! 按 Schneider 算法，以弦长参数化用最小二乘法拟合一段贝塞尔曲线，
+    误差不太大时用牛顿迭代修正参数后重新拟合，仍超出容差则在误差最大点处分为两段递归拟合。
+    各段的端点为原有点，分段点两侧的切向相同。
+    \ingroup GEOMAPI_CURVE
+    \param[in] n 点数，至少为2
+    \param[in] pts 点坐标数组，元素个数为n，相邻点不应重合
+    \param[in] tol 曲线与各点的最大允许距离
+    \param[out] out 贝塞尔曲线的控制点数组，元素个数至少为3n-2
+    \param[out] indexes 各段端点在pts中的序号，可为NULL，元素个数至少为n
+    \return 贝塞尔曲线的控制点数，为3k+1，k为曲线段数，参数有错误时为0
+    \see mgFitBezier, mgBeziersToLines
+*/
+GEOMAPI Int32 mgFitBeziers(
+    Int32 n, const Point2d* pts, float tol, Point2d* out, Int32* indexes = NULL);
+
+//! 将椭圆弧转换为折线
+/*! 按弦高不超过容差计算等角度分段数，直接计算弧上的点
+    \ingroup GEOMAPI_CURVE
+    \param[out] pxs 折线顶点数组，为NULL时只计算顶点个数
+    \param[in] maxCount pxs的元素个数，超出时不输出多余的顶点
+    \param[in] center 椭圆心
+    \param[in] rx 半长轴的长度
+    \param[in] ry 半短轴的长度，为0则取为rx
+    \param[in] startAngle 起始角度，弧度，相对于+X轴，逆时针为正
+    \param[in] sweepAngle 转角，弧度，相对于起始角度，逆时针为正
+    \param[in] tol 折线与弧的最大允许距离
+    \return 折线的全部顶点个数，可能大于maxCount，参数有错误时为0
+    \see mgEllipseToLines, mgAngleArcToBezier
+*/
+GEOMAPI Int32 mgAngleArcToLines(
+    Point2d* pxs, Int32 maxCount, const Point2d& center, float rx, float ry,
+    float startAngle, float sweepAngle, float tol);
+
+//! 将椭圆转换为多边形
+/*!
+    \ingroup GEOMAPI_CURVE
+    \param[out] pxs 多边形顶点数组，为NULL时只计算顶点个数
+    \param[in] maxCount pxs的元素个数，超出时不输出多余的顶点
+    \param[in] center 椭圆心
+    \param[in] rx 半长轴的长度
+    \param[in] ry 半短轴的长度，为0则取为rx
+    \param[in] tol 多边形与椭圆的最大允许距离
+    \return 多边形的全部顶点个数(首末点不重复)，可能大于maxCount，参数有错误时为0
+    \see mgAngleArcToLines, mgEllipseToBezier
+*/
+GEOMAPI Int32 mgEllipseToLines(
+    Point2d* pxs, Int32 maxCount, const Point2d& center, 
+    float rx, float ry, float tol);
+
 //! 计算张力样条曲线的型值点参数和弦长
 /*!
     \ingroup GEOMAPI_CURVE
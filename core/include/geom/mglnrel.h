@@ -267,6 +267,26 @@ GEOMAPI MgPtInAreaRet mgPtInArea(
     const Point2d& pt, Int32 count, const Point2d* vertexs, 
     Int32& order, const Tol& tol = Tol::gTol());
 
+//! 判断一点是否在一多边形范围内，只检查给定的边
+/*! 只检查X范围与[pt.x-容差, pt.x+容差]重叠的边，适合顶点很多的多边形，
+    由各边绑定框的索引(例如 MgSegmentTree)查找竖直窄条内的边，
+    计算量与穿过竖直线的边数成正比，不必遍历所有边。\n
+    结果与 mgPtInArea 相同，只是零长度的边(重复顶点)不在窄条内时不会被当作P所在的边。
+    \ingroup GEOMAPI_LNREL
+    \param[in] pt 给定的测试点
+    \param[in] count 多边形的顶点数
+    \param[in] vertexs 多边形的顶点数组
+    \param[in] nedges 给定的边数
+    \param[in] edges 边号数组，按从小到大排列，必须包含X范围与上述竖直窄条重叠的所有边
+    \param[out] order 返回 kMgPtAtVertex 时，输出顶点号[0, count-1]；\n
+        返回 kMgPtOnEdge 时，输出边号[0, count-1]
+    \param[in] tol 容差
+    \return 为枚举定义 MgPtInAreaRet 的各种值
+*/
+GEOMAPI MgPtInAreaRet mgPtInAreaEdges(
+    const Point2d& pt, Int32 count, const Point2d* vertexs, 
+    Int32 nedges, const Int32* edges, Int32& order, const Tol& tol = Tol::gTol());
+
 //! 判断多边形是否为凸多边形
 /*!
     \ingroup GEOMAPI_LNREL
@@ -18,6 +18,25 @@
 GEOMAPI void mgNearestOnBezier(
     const Point2d& pt, const Point2d* pts, Point2d& nearpt);
 
+//! 计算一点到多段三次贝塞尔曲线的最近点
+/*! 先用各段端点的距离作为当前最近距离，跳过控制点绑定框的距离不小于该距离的段，
+    剩下的段用等参数采样和牛顿迭代求最近点，不需要解5次方程。
+    \ingroup GEOMAPI_CURVE
+    \param[in] pt 曲线外给定的点
+    \param[in] n 曲线段数
+    \param[in] pts 控制点数组，第i段的4个控制点从 pts[i * stride] 开始
+    \param[in] stride 相邻曲线段起点的间隔，首尾相接的曲线为3，各段独立存放时为4
+    \param[in] tol 最大距离，只考虑距离不超过tol的段
+    \param[out] nearpt 曲线上的最近点
+    \param[out] segment 最近点所在的段号，没有距离在tol内的段时为-1
+    \param[out] t 最近点在该段上的参数，可为NULL
+    \return 给定点到最近点的距离，没有距离在tol内的段时为 _FLT_MAX
+    \see mgNearestOnBezier, mgCubicSplinesHit
+*/
+GEOMAPI float mgNearestOnBeziers(
+    const Point2d& pt, Int32 n, const Point2d* pts, Int32 stride,
+    float tol, Point2d& nearpt, Int32& segment, float* t = NULL);
+
 //! 计算贝塞尔曲线的绑定框
 /*!
     \ingroup GEOMAPI_CURVE
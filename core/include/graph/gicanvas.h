@@ -88,6 +88,29 @@ public:
     */
     virtual bool hasCachedBitmap(bool secondBmp = false) const = 0;
 
+    //! 保存显示内容的一个矩形区域为图块位图
+    /*! 供 GiTileCache 使用，默认不支持图块位图，GiRasterCanvas 支持
+        \param x 区域左上角X，像素
+        \param y 区域左上角Y，像素
+        \param w 区域宽度，像素
+        \param h 区域高度，像素
+        \return 图块位图的句柄，0表示失败或不支持
+        \see drawTileBitmap, releaseTileBitmap
+    */
+    virtual int saveTileBitmap(int /*x*/, int /*y*/, int /*w*/, int /*h*/) { return 0; }
+
+    //! 在指定位置显示图块位图
+    /*!
+        \param handle 由 saveTileBitmap 得到的图块位图句柄
+        \param x 位图左上角的显示位置X，像素
+        \param y 位图左上角的显示位置Y，像素
+        \return 是否显示成功
+    */
+    virtual bool drawTileBitmap(int /*handle*/, float /*x*/, float /*y*/) { return false; }
+
+    //! 释放图块位图
+    virtual void releaseTileBitmap(int /*handle*/) {}
+
     //! 返回是否正在绘图缓冲上绘图
     /*! 在派生类的 beginPaint 函数中指定是否使用绘图缓冲
         \return 是否正在绘图缓冲上绘图
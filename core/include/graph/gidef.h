@@ -6,13 +6,32 @@
 #ifndef __GEOMETRY_GIDEF_H_
 #define __GEOMETRY_GIDEF_H_
 
+// giInterlockedCasPtr: 若*p等于oldval则改为newval并返回true，带完整的内存屏障
+// giInterlockedReadPtr: 读取其他线程用 giInterlockedCasPtr 设置的指针，之后可读到其指向的完整内容
 #ifdef _MACOSX
 #include <libkern/OSAtomic.h>
 inline long giInterlockedIncrement(volatile long *p) { return OSAtomicIncrement32((volatile int32_t *)p); }
 inline long giInterlockedDecrement(volatile long *p) { return OSAtomicDecrement32((volatile int32_t *)p); }
+inline bool giInterlockedCasPtr(void* volatile *p, void* oldval, void* newval)
+    { return OSAtomicCompareAndSwapPtrBarrier(oldval, newval, p); }
+inline void* giInterlockedReadPtr(void* volatile *p)
+    { void* v = *p; OSMemoryBarrier(); return v; }
+#elif defined(__GNUC__) && !defined(_WIN32)
+inline long giInterlockedIncrement(volatile long *p) { return __sync_add_and_fetch(p, 1); }
+inline long giInterlockedDecrement(volatile long *p) { return __sync_sub_and_fetch(p, 1); }
+inline bool giInterlockedCasPtr(void* volatile *p, void* oldval, void* newval)
+    { return __sync_bool_compare_and_swap(p, oldval, newval); }
+#ifdef __ATOMIC_ACQUIRE
+inline void* giInterlockedReadPtr(void* volatile *p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+#else
+inline void* giInterlockedReadPtr(void* volatile *p) { void* v = *p; __sync_synchronize(); return v; }
+#endif
 #elif !defined(_WIN32)
 inline long giInterlockedIncrement(volatile long *p) { return ++*p; }
 inline long giInterlockedDecrement(volatile long *p) { return --*p; }
+inline bool giInterlockedCasPtr(void* volatile *p, void* oldval, void* newval)
+    { if (*p != oldval) return false; *p = newval; return true; }
+inline void* giInterlockedReadPtr(void* volatile *p) { return *p; }
 #else
 #ifndef _WINDOWS_
 #define WIN32_LEAN_AND_MEAN
@@ -20,6 +39,9 @@ inline long giInterlockedDecrement(volatile long *p) { return --*p; }
 #endif
 inline long giInterlockedIncrement(volatile long *p) { return InterlockedIncrement(p); }
 inline long giInterlockedDecrement(volatile long *p) { return InterlockedDecrement(p); }
+inline bool giInterlockedCasPtr(void* volatile *p, void* oldval, void* newval)
+    { return InterlockedCompareExchangePointer(p, newval, oldval) == oldval; }
+inline void* giInterlockedReadPtr(void* volatile *p) { void* v = *p; MemoryBarrier(); return v; }
 #endif
 
 //! 矢量路径节点类型
@@ -39,4 +61,14 @@ typedef enum {
     kGiColorMono        //!< 单色，背景色和反色
 } GiColorMode;
 
+//! 微小图形的简化显示方式
+/*! 显示尺寸小于阈值的图形按此方式显示
+    \see GiGraphics::setLodMode
+*/
+typedef enum {
+    kGiLodNone,         //!< 不简化，完整显示
+    kGiLodSimple,       //!< 显示为一个点或小矩形
+    kGiLodDensity       //!< 合并到按网格统计的密度叠加层中显示
+} GiLodMode;
+
 #endif // __GEOMETRY_GIDEF_H_
@@ -10,6 +10,112 @@
 
 class GiGraphicsImpl;
 class GiCanvas;
+struct GiTileDrawer;
+
+//! 图形显示的统计数据
+/*! 在开始绘图时清零，由 GiGraphics 和图形列表的显示函数累加
+    \ingroup GRAPH_INTERFACE
+    \see GiGraphics::stats
+*/
+struct GiDrawStats
+{
+    long    lodShapes;          //!< 按简化方式显示的微小图形数
+    long    lodCells;           //!< 密度叠加层中显示的网格数
+    long    tilesDrawn;         //!< 显示的已缓存图块数
+    long    tilesRendered;      //!< 重新绘制的图块数
+    long    panStrips;          //!< 平移显示缓冲图后重新显示的露出区域数
+    long    styleChanges;       //!< 按显示参数排序后相邻图形的参数切换次数
+    long    styleChangesSaved;  //!< 按显示参数排序减少的参数切换次数
+
+    long    shapesVisited;      //!< 图形列表中遍历的图形数
+    long    shapesCulled;       //!< 因不在剪裁框内而跳过的图形数
+    long    shapesDrawn;        //!< 显示了的图形数，含简化显示的图形
+    long    shapesOccluded;     //!< 因被不透明填充图形完全遮住而跳过的图形数
+
+    long    lines;              //!< 画布的直线段原语调用次数
+    long    polylines;          //!< 画布的折线原语调用次数
+    long    beziers;            //!< 画布的贝塞尔曲线原语调用次数
+    long    polygons;           //!< 画布的多边形原语调用次数
+    long    rects;              //!< 画布的矩形原语调用次数
+    long    ellipses;           //!< 画布的椭圆原语调用次数
+    long    paths;              //!< 画布的路径原语调用次数(按 rawEndPath 计)
+    long    points;             //!< 传给画布的坐标点数，矩形和椭圆按两个角点计
+
+    long    clipOps;            //!< 几何剪裁次数，即需要剪裁的直线、折线、曲线和多边形个数
+    long    scratchAllocs;      //!< 临时坐标缓冲区和剪裁缓冲区的堆内存分配次数，在结束绘图时得到
+
+    float   paintMs;            //!< 从开始绘图到结束绘图的时间，毫秒，在结束绘图时得到
+    float   shapesMs;           //!< 图形列表的显示时间，毫秒，含排序时间
+    float   sortMs;             //!< 按显示参数排序的时间，毫秒
+
+    GiDrawStats() { reset(); }
+
+    //! 清零
+    void reset()
+    {
+        lodShapes = 0;
+        lodCells = 0;
+        tilesDrawn = 0;
+        tilesRendered = 0;
+        panStrips = 0;
+        styleChanges = 0;
+        styleChangesSaved = 0;
+        shapesVisited = 0;
+        shapesCulled = 0;
+        shapesDrawn = 0;
+        shapesOccluded = 0;
+        lines = 0;
+        polylines = 0;
+        beziers = 0;
+        polygons = 0;
+        rects = 0;
+        ellipses = 0;
+        paths = 0;
+        points = 0;
+        clipOps = 0;
+        scratchAllocs = 0;
+        paintMs = 0;
+        shapesMs = 0;
+        sortMs = 0;
+    }
+
+    //! 累加另一个统计结果，不累加 paintMs (多线程显示时各线程的时间是重叠的)
+    void add(const GiDrawStats& src)
+    {
+        lodShapes += src.lodShapes;
+        lodCells += src.lodCells;
+        tilesDrawn += src.tilesDrawn;
+        tilesRendered += src.tilesRendered;
+        panStrips += src.panStrips;
+        styleChanges += src.styleChanges;
+        styleChangesSaved += src.styleChangesSaved;
+        shapesVisited += src.shapesVisited;
+        shapesCulled += src.shapesCulled;
+        shapesDrawn += src.shapesDrawn;
+        shapesOccluded += src.shapesOccluded;
+        lines += src.lines;
+        polylines += src.polylines;
+        beziers += src.beziers;
+        polygons += src.polygons;
+        rects += src.rects;
+        ellipses += src.ellipses;
+        paths += src.paths;
+        points += src.points;
+        clipOps += src.clipOps;
+        scratchAllocs += src.scratchAllocs;
+        shapesMs += src.shapesMs;
+        sortMs += src.sortMs;
+    }
+
+    //! 返回画布的原语调用总次数
+    long primitives() const
+    {
+        return lines + polylines + beziers + polygons + rects + ellipses + paths;
+    }
+
+    //! 返回单调递增的时钟值，毫秒，用于计算各阶段的时间
+    static double tickMs();
+};
 
 //! 图形系统类
 /*! 本类用于显示各种图形，图元显示原语由外部的 GiCanvas 实现类来实现。
@@ -26,7 +132,10 @@ public:
     virtual ~GiGraphics();
 
 public:
-    //! 复制指定对象到本对象
+    //! 复制指定对象的显示设置到本对象
+    /*! 复制线宽范围、反走样、颜色模式、简化显示、排序显示、遮挡剔除和平移缓冲等设置，
+        不复制坐标系、画布和本次绘图的统计数据。
+    */
     void copy(const GiGraphics& src);
 
     //! 返回坐标系管理对象
@@ -101,6 +210,67 @@ public:
 
     //! 设置是否为反走样模式
     bool setAntiAliasMode(bool antiAlias);
+
+    //! 返回微小图形的简化显示方式
+    GiLodMode getLodMode() const;
+
+    //! 返回需简化显示的图形尺寸阈值，像素
+    float getLodThreshold() const;
+
+    //! 返回密度叠加层的网格尺寸，像素
+    float getLodCellSize() const;
+
+    //! 设置微小图形的简化显示方式
+    /*! 显示尺寸(宽和高的较大者)小于阈值的图形不再完整显示，
+        而是按 mode 方式显示为小矩形或合并到密度叠加层中，默认不简化(kGiLodNone)，
+        设置后阈值默认为1像素，网格默认为8像素
+        \param mode 简化显示方式
+        \param pixels 图形尺寸阈值，像素，小于0时不改变
+        \param cellPixels 密度叠加层的网格尺寸，像素，小于1时不改变
+    */
+    void setLodMode(GiLodMode mode, float pixels = -1, float cellPixels = -1);
+
+    //! 返回图形列表是否按显示参数排序显示
+    bool isStyleSorting() const;
+
+    //! 设置图形列表是否按显示参数排序显示
+    /*! 排序后显示参数相同的图形尽量连续显示，以减少画布的画笔和画刷切换，
+        只在不改变重叠图形的上下次序时调整次序，默认不排序
+        \see MgStyleSorter
+    */
+    void setStyleSorting(bool sorting);
+
+    //! 返回图形列表是否跳过被遮住的图形
+    bool isOcclusionCulling() const;
+
+    //! 设置图形列表是否跳过被遮住的图形
+    /*! 为true时图形列表显示前从前往后检查图形，完全被后面的不透明填充图形遮住的图形不显示，
+        适合有大量填充图形重叠的文档，默认不检查
+        \see MgOcclusionCuller
+    */
+    void setOcclusionCulling(bool enabled);
+
+    //! 返回只平移显示后是否保留后备缓冲位图
+    bool isIncrementalPan() const;
+
+    //! 设置只平移显示后是否保留后备缓冲位图，默认不保留
+    /*! 为true时，如果放缩显示后坐标系只是平移了整数个像素，则不清除后备缓冲位图，
+        此时应调用 drawCachedBitmap(GiTileDrawer*) 平移显示缓冲图并只显示露出的区域，
+        而不是直接调用画布的 GiCanvas::drawCachedBitmap
+    */
+    void setIncrementalPan(bool enabled);
+
+    //! 显示后备缓冲位图，只平移了显示时平移显示缓冲图并只重新显示露出的区域
+    /*! 需要在绘图状态中调用，显示前应已清除背景。
+        露出的区域依次作为剪裁框调用 drawer->drawTile 显示，然后更新后备缓冲位图。
+        \param drawer 显示图形的对象
+        \return 是否显示了缓冲图，为false时需要显示全部图形并保存缓冲图
+        \see setIncrementalPan
+    */
+    bool drawCachedBitmap(GiTileDrawer* drawer);
+
+    //! 返回本次绘图的统计数据，在开始绘图时清零，结束绘图后仍可读取
+    GiDrawStats& stats();
     
 public:
     //! 绘制直线段，模型坐标或世界坐标
@@ -5,6 +5,108 @@
 
 #include "gigraph.h"
 #include "gicanvas.h"
+#include <vector>
+
+//! 绘图用的临时坐标缓冲区，按栈方式分配，在每次开始绘图时复位
+/*! 缓冲区在一帧内只增不减，超出容量时临时分配额外内存块，
+    在下次开始绘图时按本帧的峰值用量合并为一块，稳定后不再分配堆内存。
+    \see GiScratchPoints
+*/
+class GiPointArena
+{
+public:
+    GiPointArena() : m_buf(NULL), m_size(0), m_used(0), m_peak(0), m_allocs(0)
+    {
+        m_extras.reserve(8);
+    }
+
+    ~GiPointArena()
+    {
+        restore(0);
+        delete[] m_buf;
+    }
+
+    //! 返回当前已分配位置，用于 restore()
+    int mark() const { return m_used; }
+
+    //! 分配count个点的缓冲区，在调用 restore() 前有效
+    Point2d* alloc(int count)
+    {
+        Point2d* p;
+
+        if (m_used + count <= m_size) {
+            p = m_buf + m_used;
+        }
+        else {                              // 容量不够时临时分配
+            p = new Point2d[count];
+            if (m_extras.size() == m_extras.capacity())
+                m_allocs++;                 // 记录表也要扩充
+            m_extras.push_back(Extra(m_used, p));
+            m_allocs++;
+        }
+        m_used += count;
+        if (m_peak < m_used)
+            m_peak = m_used;
+
+        return p;
+    }
+
+    //! 释放 mark() 位置之后分配的缓冲区
+    void restore(int mark)
+    {
+        while (!m_extras.empty() && m_extras.back().first >= mark) {
+            delete[] m_extras.back().second;
+            m_extras.pop_back();
+        }
+        m_used = mark;
+    }
+
+    //! 开始绘图时复位，按峰值用量扩充缓冲区
+    void reset()
+    {
+        if (m_used == 0 && m_peak > m_size) {
+            delete[] m_buf;
+            m_size = (m_peak + 255) & ~255;
+            m_buf = new Point2d[m_size];
+            m_allocs++;
+        }
+    }
+
+    //! 返回累计的堆内存分配次数
+    long allocCount() const { return m_allocs; }
+
+private:
+    typedef std::pair<int, Point2d*> Extra;
+
+    Point2d*    m_buf;                  //!< 主缓冲区
+    int         m_size;                 //!< 主缓冲区的容量
+    int         m_used;                 //!< 当前已分配的点数
+    int         m_peak;                 //!< 已分配点数的峰值
+    long        m_allocs;               //!< 堆内存分配次数
+    std::vector<Extra>  m_extras;       //!< 超出容量时临时分配的内存块
+};
+
+//! 在函数范围内使用的临时坐标缓冲区，析构时自动归还
+class GiScratchPoints
+{
+    GiPointArena&   m_arena;
+    int             m_mark;
+    Point2d*        m_pts;
+public:
+    GiScratchPoints(GiPointArena& arena, int count)
+        : m_arena(arena), m_mark(arena.mark())
+    {
+        m_pts = arena.alloc(count);
+    }
+    ~GiScratchPoints()
+    {
+        m_arena.restore(m_mark);
+    }
+    Point2d* points() { return m_pts; }
+private:
+    GiScratchPoints();
+    void operator=(const GiScratchPoints&);
+};
 
 //! GiGraphics的内部实现类
 class GiGraphicsImpl
@@ -24,15 +126,37 @@ public:
     bool        isPrint;            //!< 是否打印或打印预览
     int         drawColors;         //!< 绘图DC颜色数
     GiColorMode    colorMode;      //!< 颜色模式
+    GiLodMode   lodMode;            //!< 微小图形的简化显示方式
+    float       lodThreshold;       //!< 需简化显示的图形尺寸阈值，像素
+    float       lodCellSize;        //!< 密度叠加层的网格尺寸，像素
+    bool        styleSorting;       //!< 图形列表是否按显示参数排序显示
+    bool        occlusionCulling;   //!< 图形列表是否跳过被遮住的图形
+    bool        incrementalPan;     //!< 只平移显示后是否保留后备缓冲位图
+    bool        panned;             //!< 后备缓冲位图是否需要平移显示
+    int         panX, panY;         //!< 后备缓冲位图需要平移的像素数
+    Matrix2d    lastM2D;            //!< 上次放缩后的模型坐标到显示坐标的变换矩阵
+    int         lastWidth;          //!< 上次放缩后的显示窗口宽度
+    int         lastHeight;         //!< 上次放缩后的显示窗口高度
+    GiDrawStats stats;              //!< 本次绘图的统计数据
+    double      paintStart;         //!< 开始绘图的时钟值，毫秒
+    long        allocBase;          //!< 开始绘图时临时缓冲区的内存分配次数
+    long        bufferAllocs;       //!< 剪裁缓冲区扩充容量的次数
+    size_t      bufferCapacity;     //!< 剪裁缓冲区的容量之和
     RECT_2D     clipBox0;           //!< 开始绘图时的剪裁框(LP)
 
     RECT_2D     clipBox;            //!< 剪裁框(LP)
     Box2d       rectDraw;           //!< 剪裁矩形，比clipBox略大
+    Box2d       rectClip;           //!< 几何剪裁矩形，比显示窗口略大，与剪裁框无关
     Box2d       rectDrawM;          //!< 剪裁矩形，模型坐标
     Box2d       rectDrawW;          //!< 剪裁矩形，世界坐标
     Box2d       rectDrawMaxM;       //!< 最大剪裁矩形，模型坐标
     Box2d       rectDrawMaxW;       //!< 最大剪裁矩形，世界坐标
 
+    GiPointArena    scratch;        //!< 绘图临时坐标缓冲区
+    std::vector<Point2d> clipBuf1;  //!< 多边形剪裁缓冲
+    std::vector<Point2d> clipBuf2;  //!< 多边形剪裁缓冲
+    std::vector<char> clipTypes;    //!< 曲线剪裁结果的节点类型
+
     GiGraphicsImpl(GiTransform* x) : xform(x), canvas(NULL)
     {
         drawRefcnt = 0;
@@ -42,6 +166,19 @@ public:
         maxPenWidth = 100;
         minPenWidth = 1;
         antiAlias = true;
+        lodMode = kGiLodNone;
+        lodThreshold = 1;
+        lodCellSize = 8;
+        styleSorting = false;
+        occlusionCulling = false;
+        incrementalPan = false;
+        panned = false;
+        panX = panY = 0;
+        lastWidth = lastHeight = 0;
+        paintStart = 0;
+        allocBase = 0;
+        bufferAllocs = 0;
+        bufferCapacity = 0;
     }
 
     ~GiGraphicsImpl()
@@ -55,8 +192,55 @@ public:
         rectDrawMaxM = rect * xform->displayToModel();
         rectDrawW = rectDrawM * xform->modelToWorld();
         rectDrawMaxW = rectDrawMaxM * xform->modelToWorld();
-        if (canvas)
+        if (!checkPanned() && canvas)
             canvas->clearCachedBitmap(true);
+        lastM2D = xform->modelToDisplay();
+        lastWidth = xform->getWidth();
+        lastHeight = xform->getHeight();
+    }
+
+    //! 检查是否只平移了整数个像素，是则累加平移量
+    bool checkPanned()
+    {
+        const Matrix2d& mat = xform->modelToDisplay();
+        float dx = mat.dx - lastM2D.dx;
+        float dy = mat.dy - lastM2D.dy;
+        int ix = mgRound(dx);
+        int iy = mgRound(dy);
+        float tol = 1e-5f * mgMax(fabsf(mat.m11) + fabsf(mat.m12), fabsf(mat.m21) + fabsf(mat.m22));
+
+        if (!incrementalPan || !canvas || !canvas->hasCachedBitmap()
+            || lastWidth != xform->getWidth() || lastHeight != xform->getHeight()
+            || fabsf(mat.m11 - lastM2D.m11) > tol || fabsf(mat.m12 - lastM2D.m12) > tol
+            || fabsf(mat.m21 - lastM2D.m21) > tol || fabsf(mat.m22 - lastM2D.m22) > tol
+            || fabsf(dx - ix) > 0.01f || fabsf(dy - iy) > 0.01f
+            || abs(panX + ix) >= lastWidth || abs(panY + iy) >= lastHeight) {
+            panned = false;
+            panX = panY = 0;
+            return false;
+        }
+        panX += ix;
+        panY += iy;
+        panned = true;
+
+        return true;
+    }
+
+    //! 检查剪裁缓冲区是否扩充了容量，扩充时计为一次堆内存分配
+    void checkBufferGrowth()
+    {
+        size_t capacity = clipBuf1.capacity() + clipBuf2.capacity() + clipTypes.capacity();
+
+        if (bufferCapacity != capacity) {
+            bufferCapacity = capacity;
+            bufferAllocs++;
+        }
+    }
+
+    //! 返回临时坐标缓冲区和剪裁缓冲区累计的堆内存分配次数
+    long allocCount() const
+    {
+        return scratch.allocCount() + bufferAllocs;
     }
 
 private:
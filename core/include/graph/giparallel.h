@@ -0,0 +1,76 @@
+//! \file giparallel.h
+//! \brief 定义多线程分块显示类 GiParallelRender
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+
+#ifndef __GEOMETRY_GIPARALLEL_H_
+#define __GEOMETRY_GIPARALLEL_H_
+
+#include "giraster.h"
+#include "gitiles.h"
+#include <vector>
+
+//! 多线程分块显示类
+/*! 将画布的剪裁框按显示坐标对齐的网格分为多个图块，由多个线程并行显示。
+    每个线程使用自己的内存位图画布(含坐标系和图形系统的副本)，
+    以图块为剪裁框调用 GiTileDrawer::drawTile，显示后复制回目标画布。\n
+    图块互不重叠，显示前先取目标画布上已有的内容，
+    且 GiGraphics 按显示窗口而不是剪裁框剪裁几何图形，因此结果与串行显示一致。\n
+    GiTileDrawer 需要能被多个线程同时调用，调用 draw() 期间调用者应保持图形列表的读锁定，
+    例如在 MgShapesLock(shapes, MgShapesLock::ReadOnly) 的作用范围内调用。
+    \ingroup GRAPH_INTERFACE
+*/
+class GiParallelRender
+{
+public:
+    //! 构造函数
+    /*!
+        \param threads 线程数，为0时取处理器个数
+        \param tilePixels 图块的边长，像素
+    */
+    GiParallelRender(int threads = 0, int tilePixels = 256);
+
+    //! 析构函数
+    ~GiParallelRender();
+
+    //! 返回线程数
+    int getThreadCount() const { return m_threads; }
+
+    //! 设置线程数，为0时取处理器个数
+    void setThreadCount(int threads);
+
+    //! 返回图块的边长，像素
+    int getTilePixels() const { return m_tilePixels; }
+
+    //! 设置图块的边长，像素
+    void setTilePixels(int pixels) { m_tilePixels = mgMax(pixels, 16); }
+
+    //! 在画布的当前剪裁框内并行显示图形
+    /*! 需要在画布的绘图状态中调用，显示前应已清除背景。
+        各线程的图形系统复制了画布的图形系统设置(见 GiGraphics::copy)，只有平移缓冲设置不复制，
+        因为图块画布没有可平移的后备缓冲位图，不影响显示结果。显示统计累加到画布的图形系统中。
+        \param canvas 目标画布，已调用 beginPaint()
+        \param drawer 显示图块内容的对象，会被多个线程同时调用
+        \return 各图块显示的图形个数之和
+    */
+    int draw(GiRasterCanvas& canvas, GiTileDrawer* drawer);
+
+    //! 返回处理器个数
+    static int getProcessorCount();
+
+public:
+    struct Worker;                          //!< 工作线程及其画布
+private:
+    int                     m_threads;
+    int                     m_tilePixels;
+    std::vector<Worker*>    m_workers;      //!< 各线程的画布，保留以重用位图
+    std::vector<RECT_2D>    m_rects;        //!< 本次显示的图块
+    volatile long           m_next;         //!< 下一个待显示图块的序号加1
+    GiRasterCanvas*         m_canvas;
+    GiTileDrawer*           m_drawer;
+
+    GiParallelRender(const GiParallelRender&);
+    void operator=(const GiParallelRender&);
+};
+
+#endif // __GEOMETRY_GIPARALLEL_H_
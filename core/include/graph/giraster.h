@@ -0,0 +1,137 @@
+//! \file giraster.h
+//! \brief 定义内存位图画布类 GiRasterCanvas
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+
+#ifndef __GEOMETRY_GIRASTER_H_
+#define __GEOMETRY_GIRASTER_H_
+
+#include "gicanvas.h"
+#include "gigraph.h"
+
+class GiRasterCanvasImpl;
+
+//! 在内存RGBA位图上显示图形的画布类
+/*! 本类不依赖任何平台绘图库，用扫描线面积覆盖算法实现反走样显示，
+    支持线宽、线型、半透明和后备缓冲位图，可用于在服务器端批量生成缩略图。\n
+    位图的像素格式为每像素4字节(R,G,B,A)，逐行排列，行间无填充。
+    \ingroup GRAPH_INTERFACE
+*/
+class GiRasterCanvas : public GiCanvas
+{
+public:
+    //! 构造函数
+    GiRasterCanvas();
+
+    //! 析构函数
+    virtual ~GiRasterCanvas();
+
+    //! 返回坐标系管理对象
+    GiTransform& xf() { return _xf; }
+
+    //! 返回图形系统对象
+    GiGraphics& gs() { return _gs; }
+
+    //! 准备开始绘图
+    /*! 本函数设置显示窗口大小，必要时重新分配位图。
+        位图大小改变后将清除后备缓冲位图。
+        \param width 位图宽度，像素
+        \param height 位图高度，像素
+        \param clear 是否用背景色清除位图
+        \return 是否成功，大小无效或先前绘图还未结束时失败
+        \see endPaint
+    */
+    bool beginPaint(int width, int height, bool clear = true);
+
+    //! 准备在显示窗口的一个矩形区域上绘图
+    /*! 位图只覆盖该区域，坐标系复制自 xf，剪裁框为该区域，用于分块显示。
+        区域的位置或大小改变后将清除后备缓冲位图。
+        \param xf 整个显示窗口的坐标系
+        \param x 区域左上角X，像素
+        \param y 区域左上角Y，像素
+        \param width 区域宽度，像素
+        \param height 区域高度，像素
+        \param clear 是否用背景色清除位图
+        \return 是否成功，大小无效或先前绘图还未结束时失败
+    */
+    bool beginPaint(const GiTransform& xf, int x, int y,
+                    int width, int height, bool clear = true);
+
+    //! 结束绘图，位图内容保留到下次绘图
+    void endPaint();
+
+    //! 返回位图宽度，像素
+    int getWidth() const;
+
+    //! 返回位图高度，像素
+    int getHeight() const;
+
+    //! 返回位图左上角的显示坐标X，像素
+    int getOriginX() const;
+
+    //! 返回位图左上角的显示坐标Y，像素
+    int getOriginY() const;
+
+    //! 返回位图像素数据，每像素4字节(R,G,B,A)，无位图时为NULL
+    const unsigned char* getPixels() const;
+
+    //! 返回可修改的位图像素数据
+    unsigned char* getPixels();
+
+    //! 设置显示分辨率DPI，默认为96
+    void setScreenDpi(float dpi);
+
+    //! 设置曲线和椭圆离散为折线的最大误差，像素，默认为0.25
+    /*! 误差越大则折线顶点越少，显示越快，例如快速缩放时可取为2 */
+    void setFlatness(float tol);
+
+    //! 返回曲线和椭圆离散为折线的最大误差，像素
+    float getFlatness() const;
+
+public:
+    virtual void clearWindow();
+    virtual bool drawCachedBitmap(float x = 0, float y = 0, bool secondBmp = false);
+    virtual bool drawCachedBitmap2(const GiCanvas* p, float x = 0, float y = 0, bool secondBmp = false);
+    virtual void saveCachedBitmap(bool secondBmp = false);
+    virtual bool hasCachedBitmap(bool secondBmp = false) const;
+    virtual int saveTileBitmap(int x, int y, int w, int h);
+    virtual bool drawTileBitmap(int handle, float x, float y);
+    virtual void releaseTileBitmap(int handle);
+    virtual bool isBufferedDrawing() const { return false; }
+    virtual int getCanvasType() const { return 12; }
+#ifndef SWIG
+    virtual const GiContext* getCurrentContext() const;
+#endif
+    virtual void _clipBoxChanged(const RECT_2D& clipBox);
+    virtual void _antiAliasModeChanged(bool antiAlias);
+
+    virtual void clearCachedBitmap(bool clearAll = false);
+    virtual float getScreenDpi() const;
+    virtual GiColor getBkColor() const;
+    virtual GiColor setBkColor(const GiColor& color);
+    virtual bool rawLine(const GiContext* ctx, float x1, float y1, float x2, float y2);
+    virtual bool rawLines(const GiContext* ctx, const Point2d* pxs, int count);
+    virtual bool rawBeziers(const GiContext* ctx, const Point2d* pxs, int count);
+    virtual bool rawPolygon(const GiContext* ctx, const Point2d* pxs, int count);
+    virtual bool rawRect(const GiContext* ctx, float x, float y, float w, float h);
+    virtual bool rawEllipse(const GiContext* ctx, float x, float y, float w, float h);
+    virtual bool rawBeginPath();
+    virtual bool rawEndPath(const GiContext* ctx, bool fill);
+    virtual bool rawMoveTo(float x, float y);
+    virtual bool rawLineTo(float x, float y);
+    virtual bool rawBezierTo(float c1x, float c1y, float c2x, float c2y, float x, float y);
+    virtual bool rawClosePath();
+
+private:
+    bool beginPaintRect(int x, int y, int width, int height, bool clear);
+
+private:
+    GiTransform         _xf;
+    GiGraphics          _gs;
+    GiRasterCanvasImpl* m_draw;
+
+    GiRasterCanvas(const GiRasterCanvas&);
+    void operator=(const GiRasterCanvas&);
+};
+
+#endif // __GEOMETRY_GIRASTER_H_
@@ -0,0 +1,123 @@
+//! \file gitiles.h
+//! \brief 定义多分辨率图块缓存类 GiTileCache
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+
+#ifndef __GEOMETRY_GITILES_H_
+#define __GEOMETRY_GITILES_H_
+
+#include "gigraph.h"
+#include <list>
+#include <map>
+
+//! 图块内容的绘制接口
+/*! 由 GiTileCache 在缺少图块时调用，此时图形系统已设置为该图块的剪裁框
+    \ingroup GRAPH_INTERFACE
+    \interface GiTileDrawer
+*/
+struct GiTileDrawer
+{
+    virtual ~GiTileDrawer() {}
+
+    //! 在图形系统的当前剪裁框内显示图形，返回显示的图形个数
+    virtual int drawTile(GiGraphics& gs) = 0;
+};
+
+//! 多分辨率图块缓存类
+/*! 将显示区域按世界坐标对齐的网格分为固定像素大小的图块，
+    图块位图由画布的 GiCanvas::saveTileBitmap 等函数创建和显示，
+    以(放缩级别, 图块列号, 图块行号)为键缓存，按最近最少使用原则在内存预算内淘汰。
+    平移和放缩显示后只需显示已有图块并绘制缺少的图块。
+    画布不支持图块位图时每次都重新显示整个区域，目前只有 GiRasterCanvas 支持。\n
+    图形改变后调用 invalidate() 清除受影响的图块，改变模型变换矩阵后调用 clear()。
+    \ingroup GRAPH_INTERFACE
+*/
+class GiTileCache
+{
+public:
+    //! 构造函数
+    /*!
+        \param tilePixels 图块的边长，像素
+        \param maxBytes 图块位图占用内存的预算，字节
+    */
+    GiTileCache(int tilePixels = 256, long maxBytes = 32 * 1024 * 1024);
+
+    //! 析构函数，释放所有图块位图
+    ~GiTileCache();
+
+    //! 返回图块的边长，像素
+    int getTilePixels() const { return m_tilePixels; }
+
+    //! 返回图块位图占用内存的预算，字节
+    long getBudget() const { return m_maxBytes; }
+
+    //! 设置图块位图占用内存的预算，超出时立即淘汰
+    void setBudget(long maxBytes);
+
+    //! 返回图块位图已占用的内存，字节
+    long getUsedBytes() const { return m_usedBytes; }
+
+    //! 返回已缓存的图块数
+    int getTileCount() const { return (int)m_tiles.size(); }
+
+    //! 设置图形线宽等超出图形范围的余量，像素，用于 invalidate()
+    void setMargin(float pixels) { m_margin = pixels; }
+
+    //! 清除所有图块
+    void clear();
+
+    //! 清除与指定区域相交的图块
+    /*!
+        \param rectWorld 图形改变的区域，世界坐标
+        \return 清除的图块数
+    */
+    int invalidate(const Box2d& rectWorld);
+
+    //! 显示当前剪裁框内的图块，绘制并缓存缺少的图块
+    /*! 需要在图形系统的绘图状态中调用，显示前应已清除背景。
+        如果画布不支持图块位图，则直接在当前剪裁框内绘制。
+        \param gs 图形系统，其画布需实现 GiCanvas::saveTileBitmap 等函数
+        \param drawer 绘制图块内容的对象
+        \return 绘制的图形个数
+    */
+    int draw(GiGraphics& gs, GiTileDrawer* drawer);
+
+private:
+    struct TileKey {
+        int     level;              //!< 放缩级别
+        int     tx;                 //!< 图块列号
+        int     ty;                 //!< 图块行号
+
+        bool operator<(const TileKey& k) const {
+            return level < k.level || (level == k.level
+                && (tx < k.tx || (tx == k.tx && ty < k.ty)));
+        }
+    };
+    struct Tile {
+        TileKey key;
+        int     handle;             //!< 画布创建的图块位图
+        float   scale;              //!< 创建时的世界坐标到像素的比例
+        float   fx, fy;             //!< 位图原点与图块原点的像素偏差
+        long    bytes;              //!< 位图占用内存
+        Box2d   rectW;              //!< 图块的世界坐标范围
+    };
+    typedef std::list<Tile> TileList;
+    typedef std::map<TileKey, TileList::iterator> TileMap;
+
+    void releaseTile(TileList::iterator it);
+    void evict();
+
+    int         m_tilePixels;
+    long        m_maxBytes;
+    long        m_usedBytes;
+    float       m_margin;
+    bool        m_unsupported;      //!< 画布不支持图块位图
+    GiCanvas*   m_canvas;           //!< 创建图块位图的画布
+    TileList    m_tiles;            //!< 图块，最近使用的在前
+    TileMap     m_map;
+
+    GiTileCache(const GiTileCache&);
+    void operator=(const GiTileCache&);
+};
+
+#endif // __GEOMETRY_GITILES_H_
@@ -7,6 +7,10 @@
 #define __GEOMETRY_BASICSHAPE_H_
 
 #include "mgshape.h"
+#include <vector>
+
+class MgSegmentTree;
+class MgArcLength;
 
 //! 线段图形类
 /*! \ingroup GEOM_SHAPE
@@ -240,10 +244,39 @@ protected:
     bool _save(MgStorage* s) const;
     bool _load(MgStorage* s);
 
+    //! 返回各段的绑定框层次，段数较少时返回NULL，应逐段检查
+    /*! 在第一次使用时生成，改变顶点后自动作废。
+        显示时可在多个线程中同时调用，改变顶点时需要独占图形。
+        \param knotvs 三次样条曲线的型值点切矢量数组，为NULL时各段为直线段
+    */
+    const MgSegmentTree* _getSegmentTree(const Vector2d* knotvs) const;
+
+    //! 返回各段的累计弧长表，在第一次使用时生成，改变顶点后自动作废
+    /*! 可在多个线程中同时调用，改变顶点时需要独占图形。
+        \param knotvs 三次样条曲线的型值点切矢量数组，为NULL时各段为直线段
+    */
+    const MgArcLength* _getArcLength(const Vector2d* knotvs) const;
+
+    //! 作废各段的绑定框层次和弧长表
+    void _clearCaches();
+
+    //! 查找与显示区域相交的连续段，用于只显示可见部分
+    /*! 不闭合的实线图形在段数较多且部分可见时才查找。
+        \param knotvs 三次样条曲线的型值点切矢量数组，为NULL时各段为直线段
+        \param runs 依次输出各连续可见段的起始段号和末尾段号
+        \return 是否找到部分可见段，为false时应显示整个图形
+    */
+    bool _findVisibleRuns(GiGraphics& gs, const GiContext& ctx, const Vector2d* knotvs,
+                          std::vector<Int32>& runs) const;
+
 protected:
+    enum { MIN_TREE_SEGMENTS = 64 };    //!< 生成绑定框层次的最少段数
+
     Point2d*    _points;
     UInt32      _maxCount;
     UInt32      _count;
+    mutable MgSegmentTree* volatile _segtree;   //!< 各段的绑定框层次，在第一次使用时生成并原子地设置
+    mutable MgArcLength* volatile _arclen;      //!< 各段的累计弧长表，在第一次使用时生成并原子地设置
 };
 
 //! 折线图形类
@@ -252,6 +285,9 @@ protected:
 class MgLines : public MgBaseLines
 {
     MG_INHERIT_CREATE(MgLines, MgBaseLines, 15)
+public:
+    //! 返回各段的累计弧长表，用于按弧长和参数(段号+段内比例)相互换算
+    const MgArcLength* getArcLength() const { return _getArcLength(NULL); }
 protected:
 };
 
@@ -263,16 +299,46 @@ class MgSplines : public MgBaseLines
     MG_INHERIT_CREATE(MgSplines, MgBaseLines, 16)
 public:
     //! 去掉多余点，同时仍然光滑
+    /*! 依次检查各点，去掉一个点后只在附近几个点的窗口内重新计算切矢量，
+        已去掉的点到新曲线的距离都小于tol且切向变化不大时才去掉，计算量与点数成线性关系。
+        \param tol 允许的偏离距离
+    */
     void smooth(float tol);
     
+    //! 将原始采样点拟合为尽量少的型值点，各采样点到曲线的距离都不超过tol
+    /*! 先用 mgFitBeziers 拟合得到分段点作为型值点，
+        再在样条曲线偏离超出容差的各段中加入偏离最大的采样点，直到都在容差内。
+        \param tol 允许的偏离距离
+    */
+    void fitKnots(float tol);
+    
+    //! 绘制过程中的增量更新，只重新计算末尾几个型值点的切矢量并扩大绑定框
+    /*! 仅适用于只在末尾添加或移动型值点的不闭合曲线，窗口起点的切矢量保持不变。
+        其余情况自动改为调用 update()，绘制结束后应调用 update() 重新整体计算。
+    */
+    void updateTail();
+    
+    //! 返回曲线的累计弧长表，用于按弧长和参数(段号+段内参数)相互换算
+    /*! 在第一次使用时按曲线的贝塞尔控制点自适应采样生成，改变型值点或 update() 后自动作废。
+        尚未计算切矢量时按折线计算。
+    */
+    const MgArcLength* getArcLength() const;
+    
 protected:
     void _update();
     float _hitTest(const Point2d& pt, float tol, Point2d& nearpt, Int32& segment) const;
     bool _hitTestBox(const Box2d& rect) const;
 
 protected:
+    enum { TAIL = 8 };          //!< 增量更新时重新计算切矢量的末尾型值点数
+    enum { SMOOTH_WINDOW = 3 }; //!< smooth() 局部重新计算时被检查点后面的型值点数
+    enum { MAX_SKIP = 16 };     //!< smooth() 最多连续去掉的型值点数
+
     Vector2d*   _knotvs;
     UInt32      _bzcount;
+    UInt32      _solved;        //!< 已计算切矢量的型值点数
+    UInt32      _frozen;        //!< _frozenBox 已包含的曲线段数
+    Box2d       _frozenBox;     //!< 增量更新时不再改变的前面曲线段的绑定框
 };
 
 //! 矩形图形基类
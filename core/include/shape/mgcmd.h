@@ -14,6 +14,7 @@ struct MgView;
 struct MgMotion;
 struct MgCommand;
 class MgBaseCommand;
+class MgPickBuffer;
 struct MgCommandManager;
 struct MgSnap;
 struct MgActionDispatcher;
@@ -51,6 +52,7 @@ struct MgView {
     virtual GiContext* context() {              //!< 得到当前绘图属性
         return shapes() ? shapes()->context() : NULL; }
     virtual bool useFinger() { return true; }   //!< 使用手指或鼠标交互
+    virtual MgPickBuffer* pickBuffer() { return NULL; } //!< 得到点选缓冲，为NULL时遍历图形点选
     virtual void selChanged() {}                //!< 选择集改变的通知
     
     virtual bool shapeWillAdded(MgShape* shape) {       //!< 通知将添加图形
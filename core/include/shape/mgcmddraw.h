@@ -16,6 +16,11 @@ float mgLineHalfWidthModel(const MgShape* shape, const MgMotion* sender);
 float mgDisplayMmToModel(float mm, GiGraphics* gs);
 float mgDisplayMmToModel(float mm, const MgMotion* sender);
 
+//! 点选图形，视图有点选缓冲时只精确计算缓冲中点击处附近的图形
+/*! \see MgView::pickBuffer, MgPickBuffer::hitTest, MgShapes::hitTest */
+MgShape* mgHitTestShapes(const MgMotion* sender, const Box2d& limits,
+                         Point2d& nearpt, Int32& segment);
+
 //! 绘图命令基类
 /*! example: mgRegisterCommand(YourCmd::Name(), YourCmd::Create);
     \ingroup GEOM_SHAPE
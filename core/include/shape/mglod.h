@@ -0,0 +1,57 @@
+//! \file mglod.h
+//! \brief 定义微小图形的简化显示辅助类 MgLodDrawer
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+
+#ifndef __GEOMETRY_MGLOD_H_
+#define __GEOMETRY_MGLOD_H_
+
+#include <mgshape.h>
+#include <gigraph.h>
+#include <vector>
+
+//! 微小图形的简化显示辅助类
+/*! 显示尺寸小于 GiGraphics::getLodThreshold() 的图形不再调用其显示函数，
+    而是显示为小矩形，或累积到按网格统计的密度叠加层中。
+    遇到需完整显示的图形时先显示已累积的叠加层，保持图形的上下次序，
+    由 end() 显示最后的叠加层。在图形列表的显示函数中使用。
+    \ingroup GEOM_SHAPE
+    \see GiGraphics::setLodMode
+*/
+class MgLodDrawer
+{
+public:
+    MgLodDrawer(GiGraphics& gs);
+
+    //! 如果图形的显示尺寸小于阈值就简化显示
+    /*!
+        \param shape 要显示的图形
+        \param ctx 显示参数，可为NULL
+        \return 是否已简化显示，为false时需要完整显示该图形
+    */
+    bool drawTiny(const MgShape* shape, const GiContext* ctx);
+
+    //! 显示剩下的密度叠加层，返回共显示的网格数
+    int end();
+
+private:
+    int flush();
+
+    struct Cell {
+        float   clear;          //!< 未覆盖的比例
+        float   r, g, b;        //!< 按覆盖比例加权的颜色累计值
+        float   weight;         //!< 覆盖比例累计值
+    };
+
+    GiGraphics&         _gs;
+    GiLodMode           _mode;
+    float               _threshold;
+    float               _cellSize;
+    int                 _cols;
+    int                 _rows;
+    std::vector<Cell>   _cells;
+    std::vector<int>    _used;          //!< 已累积图形的网格序号
+    int                 _count;         //!< 已显示的网格数
+};
+
+#endif // __GEOMETRY_MGLOD_H_
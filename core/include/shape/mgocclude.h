@@ -0,0 +1,65 @@
+//! \file mgocclude.h
+//! \brief 定义被遮挡图形的剔除辅助类 MgOcclusionCuller
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+
+#ifndef __GEOMETRY_MGOCCLUDE_H_
+#define __GEOMETRY_MGOCCLUDE_H_
+
+#include <mgshape.h>
+#include <gigraph.h>
+#include <vector>
+
+//! 被遮挡图形的剔除辅助类
+/*! 在 GiGraphics::isOcclusionCulling() 为true时，图形列表的显示函数先用 add() 收集可见图形，
+    再调用 cull() 从前往后(从列表末尾往前)检查各图形，跳过完全被后面的不透明填充图形遮住的图形，
+    然后按原次序显示剩下的图形。\n
+    遮挡区域记录在剪裁框上的粗网格中，只有完全落在不透明填充图形内接矩形中的网格才算被遮住，
+    目前只有水平显示的矩形、椭圆、圆角矩形和菱形可作为遮挡图形，因此剔除是保守的，
+    显示结果与不剔除时一致。
+    \ingroup GEOM_SHAPE
+    \see GiGraphics::setOcclusionCulling
+*/
+class MgOcclusionCuller
+{
+public:
+    //! 构造函数
+    /*!
+        \param gs 图形系统
+        \param ctx 图形列表显示时传入的附加显示参数，可为NULL
+    */
+    MgOcclusionCuller(GiGraphics& gs, const GiContext* ctx);
+
+    //! 返回是否需要剔除，为false时应直接显示图形
+    bool enabled() const { return _enabled; }
+
+    //! 添加一个可见图形，按图形列表中的次序添加
+    void add(const MgShape* shape) { _shapes.push_back(shape); }
+
+    //! 剔除被遮挡的图形，返回剩下的图形个数，并记录剔除的图形个数
+    int cull();
+
+    //! 返回剩下的指定序号的图形，按图形列表中的次序
+    const MgShape* getShape(int index) const { return _shapes[_order[index]]; }
+
+private:
+    enum { CELL = 8 };              //!< 网格尺寸，像素
+
+    bool getOccluder(const MgShape* shape, Box2d& inner) const;
+    Box2d getDrawRect(const MgShape* shape) const;
+    bool isCovered(const Box2d& rect) const;
+    void cover(const Box2d& rect);
+
+    GiGraphics&         _gs;
+    const GiContext*    _ctx;
+    bool                _enabled;
+    float               _x0;        //!< 网格左上角X，像素
+    float               _y0;        //!< 网格左上角Y，像素
+    int                 _cols;
+    int                 _rows;
+    std::vector<char>   _cells;     //!< 各网格是否已被遮住
+    std::vector<const MgShape*> _shapes;
+    std::vector<int>    _order;
+};
+
+#endif // __GEOMETRY_MGOCCLUDE_H_
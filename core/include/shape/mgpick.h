@@ -0,0 +1,75 @@
+//! \file mgpick.h
+//! \brief 定义按图形ID位图点选图形的缓冲类 MgPickBuffer
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+
+#ifndef __GEOMETRY_MGPICK_H_
+#define __GEOMETRY_MGPICK_H_
+
+#include <mgshapes.h>
+#include <giraster.h>
+#include <vector>
+
+//! 按图形ID位图点选图形的缓冲类
+/*! 本对象将显示窗口划分为边长 CELL_PIXELS 像素的网格，在每格一个像素的低分辨率位图上
+    逐个显示图形，线条加宽一格并补上圆头，填充图形同时填充内部，记下每个图形经过的网格。
+    每格记录经过它的所有图形ID，而不只是最上面的图形，因此被遮住的图形仍是候选图形。\n
+    点选时只需对点击范围内各格中的图形按显示次序调用其 hitTest，结果与 MgShapes::hitTest 相同。
+    位图不在点选时生成，应在显示完图形后调用 update() (例如与后备缓冲位图一起刷新)，
+    图形列表或显示坐标系改变后位图过期，点选时改为遍历所有图形，直到下次 update()。\n
+    每次生成都要显示整个文档(3000条样条曲线约0.4秒)，点选时仍要逐个计算格中的候选图形，
+    对曲线并不比遍历快，因此视图默认不使用，只适合图形很多、很少修改而点选频繁的场合。
+    \ingroup GEOM_SHAPE
+    \see MgView::pickBuffer, mgHitTestShapes
+*/
+class MgPickBuffer
+{
+public:
+    enum { CELL_PIXELS = 4 };       //!< 网格边长，像素
+
+    MgPickBuffer();
+
+    //! 标记位图待重新生成
+    void invalidate() { _valid = false; }
+
+    //! 返回位图是否与图形列表和坐标系一致
+    bool isValid(MgShapes* shapes, const GiTransform& xf) const;
+
+    //! 位图过期时重新生成，返回位图是否可用
+    /*! 生成时间与图形个数和网格数成正比，应在显示后调用，不要在点选时调用 */
+    bool update(MgShapes* shapes, const GiTransform& xf);
+
+    //! 点选图形，结果同 MgShapes::hitTest，但只精确计算点击处附近网格中的图形
+    /*! 位图过期、图形列表正在修改或点击范围超出显示窗口时改为调用 MgShapes::hitTest
+        \param shapes 图形列表
+        \param xf 显示坐标系
+        \param limits 点击范围，模型坐标，中心为点击位置
+        \param nearpt 返回图形上的最近点，模型坐标
+        \param segment 返回最近点所在的段号
+        \return 点中的图形，没有点中时返回NULL
+    */
+    MgShape* hitTest(MgShapes* shapes, const GiTransform& xf, const Box2d& limits,
+                     Point2d& nearpt, Int32& segment);
+
+private:
+    bool render(MgShapes* shapes, const GiTransform& xf);
+    bool collectCells(Int32 index, int x1, int y1, int x2, int y2);
+    void addCell(int cell, Int32 index);
+
+    GiRasterCanvas  _canvas;        //!< 逐个显示图形的网格位图，A不为0表示图形覆盖该格
+    GiTransform     _cellxf;        //!< 网格位图的坐标系，一个像素对应一格
+    bool            _valid;         //!< 位图是否已生成且可用
+    UInt32          _changeCount;   //!< 生成位图时图形列表的改变计数
+    Matrix2d        _m2d;           //!< 生成位图时的模型坐标到显示坐标的变换矩阵
+    int             _width;         //!< 生成位图时的显示窗口宽度
+    int             _height;        //!< 生成位图时的显示窗口高度
+    std::vector<Int32>  _heads;     //!< 每格的第一个记录序号，-1表示没有图形
+    std::vector<Int32>  _nexts;     //!< 同一格的下一个记录序号
+    std::vector<Int32>  _cellShapes;    //!< 各记录的图形在 _shapes 中的序号
+    std::vector<MgShape*> _shapes;  //!< 按显示次序排列的图形，改变计数不变时都有效
+    std::vector<Int32>  _found;     //!< 候选图形的序号
+    std::vector<UInt32> _marks;     //!< 各图形最近一次成为候选图形时的点选次数，用于去掉重复
+    UInt32              _stamp;     //!< 点选次数
+};
+
+#endif // __GEOMETRY_MGPICK_H_
@@ -0,0 +1,109 @@
+//! \file mgprogress.h
+//! \brief 定义分步显示图形列表的进度类 MgDrawProgress
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+
+#ifndef __GEOMETRY_MGPROGRESS_H_
+#define __GEOMETRY_MGPROGRESS_H_
+
+#include <mgshape.h>
+#include <gigraph.h>
+#include <vector>
+
+//! 分步显示图形列表的进度类
+/*! 图形很多时一次显示全部图形会长时间阻塞界面线程，可改用 MgShapes::drawPart 分多帧显示：
+    每次调用只显示到时间或原语个数的预算用完为止，本对象记下显示位置，
+    下一帧先显示上次保存的缓冲图，再调用 drawPart 继续显示，直到 isDrawing() 为false。\n
+    图形列表改变、放缩或剪裁框改变后 drawPart 将自动从头显示，
+    调用者清除缓冲图或换用另一个图形列表时应调用 restart()。\n
+    按尺寸优先显示时大图形先显示，画面收敛更快，但不保证重叠图形的上下次序。
+    \ingroup GEOM_SHAPE
+    \see MgShapes::drawPart
+*/
+class MgDrawProgress
+{
+public:
+    //! 构造函数
+    /*!
+        \param budgetMs 每次显示的时间预算，毫秒，为0则不限时间
+        \param budgetPrims 每次显示的画布原语个数预算，为0则不限个数
+    */
+    MgDrawProgress(float budgetMs = 30, long budgetPrims = 0);
+
+    //! 返回每次显示的时间预算，毫秒
+    float getBudgetMs() const { return _budgetMs; }
+
+    //! 返回每次显示的画布原语个数预算
+    long getBudgetPrims() const { return _budgetPrims; }
+
+    //! 设置每次显示的预算，均为0时 drawPart 一次显示全部图形
+    void setBudget(float ms, long primitives = 0);
+
+    //! 返回是否按尺寸从大到小的次序显示
+    bool isLargeFirst() const { return _largeFirst; }
+
+    //! 设置是否按尺寸从大到小的次序显示，在下次从头显示时生效
+    void setLargeFirst(bool largeFirst) { _largeFirst = largeFirst; }
+
+    //! 清除显示进度，下次从头显示
+    void restart();
+
+    //! 返回是否已开始显示但还未显示完，为true时需要再次调用 drawPart
+    bool isDrawing() const { return _started && _pos < (int)_order.size(); }
+
+    //! 返回本次需要显示的图形个数，即在剪裁框内的图形个数
+    int getTotal() const { return (int)_order.size(); }
+
+    //! 返回已显示的图形个数
+    int getPosition() const { return _pos; }
+
+#ifndef SWIG
+    //! 收集图形列表中的所有图形，在 begin() 前调用
+    /*! 收集的图形保留到图形列表改变为止，改变计数相同时不再重新收集 */
+    template <class Iterator>
+    void collect(Iterator first, Iterator last, UInt32 changeCount) {
+        if (!_collected || _shapesCount != changeCount) {
+            _shapes.assign(first, last);
+            _collected = true;
+            _shapesCount = changeCount;
+        }
+    }
+
+    //! 开始一次显示，必要时从头显示，返回是否还有需要显示的图形
+    bool begin(GiGraphics& gs, UInt32 changeCount);
+
+    //! 返回下一个要显示的图形，预算用完或已显示完时返回NULL
+    const MgShape* next();
+
+    //! 结束一次显示
+    void end();
+#endif
+
+private:
+    struct Item {
+        int             index;      //!< 在图形列表中的序号
+        UInt32          id;         //!< 图形的ID，用于检查图形列表是否改变
+        float           size;       //!< 显示尺寸，像素
+        bool operator<(const Item& r) const { return size > r.size; }
+    };
+
+    float           _budgetMs;
+    long            _budgetPrims;
+    bool            _largeFirst;
+    bool            _started;       //!< 是否已开始显示
+    bool            _collected;     //!< 是否已收集图形
+    UInt32          _shapesCount;   //!< 收集图形时图形列表的改变计数
+    int             _pos;           //!< 下一个要显示的图形在 _order 中的序号
+    UInt32          _changeCount;   //!< 开始显示时图形列表的改变计数
+    long            _zoomTimes;     //!< 开始显示时坐标系的放缩次数
+    Box2d           _clip;          //!< 开始显示时的剪裁框，模型坐标
+
+    GiGraphics*     _gs;            //!< 本次显示的图形系统
+    double          _tick;          //!< 本次显示的开始时间，毫秒
+    long            _prims;         //!< 本次显示开始时的画布原语个数
+    int             _drawn;         //!< 本次显示的图形个数
+    std::vector<Item>           _order;     //!< 显示次序
+    std::vector<const MgShape*> _shapes;    //!< 收集的图形，图形列表改变前一直有效
+};
+
+#endif // __GEOMETRY_MGPROGRESS_H_
@@ -0,0 +1,54 @@
+//! \file mgsegtree.h
+//! \brief 定义折线和曲线各段的绑定框层次类 MgSegmentTree
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+
+#ifndef __GEOMETRY_MGSEGTREE_H_
+#define __GEOMETRY_MGSEGTREE_H_
+
+#include <mgbox.h>
+#include <vector>
+
+//! 折线和曲线各段的绑定框层次类
+/*! 第0层为各段的绑定框，上一层每个框包含下一层相邻 FANOUT 个框，直到只剩一个框。
+    由于相邻段在空间上也相邻，按段号分组即可得到紧凑的层次，
+    查找与矩形相交的段时只需逐层检查相交的框，计算量与段数成对数关系，
+    查找结果按段号从小到大排列，可直接得到连续的可见段。
+    \ingroup GEOM_SHAPE
+    \see MgBaseLines
+*/
+class MgSegmentTree
+{
+public:
+    //! 由各段的绑定框生成
+    /*!
+        \param count 段数
+        \param boxes 各段的绑定框数组，元素个数为count
+    */
+    void build(Int32 count, const Box2d* boxes);
+
+    //! 返回段数
+    Int32 getCount() const { return _levels.empty() ? 0 : _levels[1]; }
+
+    //! 判断是否有段的绑定框与矩形相交
+    bool isIntersect(const Box2d& rect) const;
+
+    //! 查找绑定框与矩形相交的段
+    /*!
+        \param rect 查找范围
+        \param segments 按段号从小到大添加找到的段号
+        \return 找到的段数
+    */
+    Int32 findSegments(const Box2d& rect, std::vector<Int32>& segments) const;
+
+private:
+    enum { FANOUT = 8 };            //!< 每个框包含的下一层框数
+
+    bool find(const Box2d& rect, Int32 level, Int32 first,
+              std::vector<Int32>* segments) const;
+
+    std::vector<Box2d>  _boxes;     //!< 各层的绑定框，第0层为各段的绑定框
+    std::vector<Int32>  _levels;    //!< 各层在_boxes中的起始位置，末尾为框的总数
+};
+
+#endif // __GEOMETRY_MGSEGTREE_H_
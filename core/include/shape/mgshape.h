@@ -51,6 +51,7 @@ struct MgShape : public MgObject
 
     virtual GiContext* context() = 0;
     virtual const GiContext* contextc() const = 0;
+    virtual void setContext(const GiContext& ctx) = 0;
     virtual MgBaseShape* shape() = 0;
     virtual const MgBaseShape* shapec() const = 0;
     virtual bool draw(GiGraphics& gs, const GiContext *ctx = NULL) const = 0;
@@ -9,6 +9,8 @@
 #include <mgshape.h>
 
 class MgLockRW;
+class MgDrawProgress;
+class MgStyleTable;
 
 //! 图形列表接口
 /*! \ingroup GEOM_SHAPE
@@ -31,6 +33,9 @@ struct MgShapes : public MgObject
     
     virtual MgShape* hitTest(const Box2d& limits, Point2d& nearpt, Int32& segment) const = 0;
     virtual int draw(GiGraphics& gs, const GiContext *ctx = NULL) const = 0;
+    
+    //! 在预算内分步显示图形，从上次的进度继续显示，返回本次显示的图形个数
+    virtual int drawPart(GiGraphics& gs, MgDrawProgress& progress, const GiContext *ctx = NULL) const = 0;
     virtual UInt32 getChangeCount() = 0;
     virtual void afterChanged() = 0;
     virtual bool save(MgStorage* s, UInt32 startIndex = 0) const = 0;
@@ -59,6 +64,9 @@ struct MgShapes : public MgObject
     
     //! 得到锁定数据对象以便读写锁定
     virtual MgLockRW* getLockData() = 0;
+    
+    //! 返回图形共享的显示参数表
+    virtual MgStyleTable* getStyleTable() = 0;
 };
 
 #ifndef SWIG
@@ -9,6 +9,11 @@
 #include <mgshapes.h>
 #include <mgstorage.h>
 #include <gigraph.h>
+#include <mglod.h>
+#include <mgsorter.h>
+#include <mgocclude.h>
+#include <mgprogress.h>
+#include <mgstyle.h>
 
 MgShape* mgCreateShape(UInt32 type);
 
@@ -25,7 +30,7 @@ class MgShapesT : public MgShapes
     typedef typename Container::iterator iterator;
 public:
     MgShapesT(bool hasContext = true) : _context(hasContext ? new ContextT() : NULL)
-        , _changeCount(0)
+        , _styles(MgStyleTable::create()), _changeCount(0)
     {
     }
 
@@ -33,6 +38,7 @@ public:
     {
         clear();
         delete _context;
+        _styles->release();
     }
 
     static UInt32 Type() { return 0x10000 | MgShapes::Type(); }
@@ -213,14 +219,71 @@ public:
     {
         Box2d clip(gs.getClipModel());
         int count = 0;
+        GiDrawStats& stats = gs.stats();
+        double tick = GiDrawStats::tickMs();
+        MgLodDrawer lod(gs);
+        MgStyleSorter sorter(gs);
+        MgOcclusionCuller culler(gs, ctx);
         
         for (const_iterator it = _shapes.begin(); it != _shapes.end(); ++it)
         {
             if ((*it)->shape()->getExtent().isIntersect(clip)) {
-                if ((*it)->draw(gs, ctx))
+                if (culler.enabled())
+                    culler.add(*it);
+                else if (sorter.enabled())
+                    sorter.add(*it);
+                else if (lod.drawTiny(*it, ctx) || (*it)->draw(gs, ctx))
                     count++;
             }
+            else {
+                stats.shapesCulled++;
+            }
+        }
+        if (culler.enabled()) {
+            int n = culler.cull();
+            for (int i = 0; i < n; i++) {
+                const MgShape* shape = culler.getShape(i);
+                if (sorter.enabled())
+                    sorter.add(shape);
+                else if (lod.drawTiny(shape, ctx) || shape->draw(gs, ctx))
+                    count++;
+            }
+        }
+        if (sorter.enabled()) {
+            double sortTick = GiDrawStats::tickMs();
+            int n = sorter.sort();
+            stats.sortMs += (float)(GiDrawStats::tickMs() - sortTick);
+            for (int i = 0; i < n; i++) {
+                const MgShape* shape = sorter.getShape(i);
+                if (lod.drawTiny(shape, ctx) || shape->draw(gs, ctx))
+                    count++;
+            }
+        }
+        lod.end();
+        
+        stats.shapesVisited += (long)_shapes.size();
+        stats.shapesDrawn += count;
+        stats.shapesMs += (float)(GiDrawStats::tickMs() - tick);
+        
+        return count;
+    }
+    
+    int drawPart(GiGraphics& gs, MgDrawProgress& progress, const GiContext *ctx = NULL) const
+    {
+        int count = 0;
+        
+        progress.collect(_shapes.begin(), _shapes.end(), (UInt32)_changeCount);
+        if (progress.begin(gs, (UInt32)_changeCount)) {
+            MgLodDrawer lod(gs);
+            
+            for (const MgShape* shape = progress.next(); shape; shape = progress.next()) {
+                if (lod.drawTiny(shape, ctx) || shape->draw(gs, ctx))
+                    count++;
+            }
+            lod.end();
+            gs.stats().shapesDrawn += count;
         }
+        progress.end();
         
         return count;
     }
@@ -360,6 +423,11 @@ public:
     {
         return &_lock;
     }
+    
+    virtual MgStyleTable* getStyleTable()
+    {
+        return _styles;
+    }
 
 private:
     UInt32 getNewID(UInt32 nID)
@@ -382,6 +450,7 @@ private:
 protected:
     Container               _shapes;
     ContextT*               _context;
+    MgStyleTable*           _styles;        //!< 图形共享的显示参数表
     Matrix2d                _xf;
     Box2d                   _rectW;
     long                    _changeCount;
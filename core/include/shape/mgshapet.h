@@ -7,11 +7,20 @@
 #define __GEOMETRY_MGSHAPE_TEMPL_H_
 
 #include <gigraph.h>
-#include <mgshape.h>
+#include <mgshapes.h>
 #include <mgstorage.h>
+#include <mgstyle.h>
+
+//! 显示参数类型能否放入共享显示参数表，表中只保存 GiContext，派生类型的图形总是自有显示参数
+template <class ContextT> struct MgStyleShareable { enum { value = 0 }; };
+template <> struct MgStyleShareable<GiContext> { enum { value = 1 }; };
 
 //! 矢量图形模板类
-/*! \ingroup GEOM_SHAPE
+/*! 在图形列表写锁定时添加、复制、加载或调用 setContext() 后，图形的显示参数保存在
+    图形列表的共享显示参数表中，图形只记下句柄。修改显示参数应复制 contextc() 修改后
+    调用 setContext()，调用 context() 会将显示参数复制为图形自有的，直到下次设置。
+    \ingroup GEOM_SHAPE
+    \see MgStyleTable, MgStyleShareable
  */
 template <class ShapeT, class ContextT = GiContext>
 class MgShapeT : public MgShape
@@ -19,32 +28,79 @@ class MgShapeT : public MgShape
     typedef MgShapeT<ShapeT, ContextT> ThisClass;
 public:
     ShapeT      _shape;
-    ContextT    _context;
     UInt32      _id;
     MgShapes*   _parent;
     UInt32      _tag;
     
-    MgShapeT() : _id(0), _parent(NULL), _tag(0)
+    MgShapeT() : _id(0), _parent(NULL), _tag(0), _context(new ContextT()), _style(0)
     {
     }
     
     MgShapeT(const ContextT& ctx) : _id(0), _parent(NULL), _tag(0)
+        , _context(new ContextT(ctx)), _style(0)
+    {
+    }
+    
+    MgShapeT(const ThisClass& src) : _shape(src._shape), _id(src._id)
+        , _parent(src._parent), _tag(src._tag), _style(0)
     {
-        _context = ctx;
+        if (src._style) {                       // 不一定在写锁定中，不增加表项的引用
+            _context = new ContextT();
+            static_cast<GiContext&>(*_context) = *src.contextc();
+        }
+        else {
+            _context = new ContextT(*src._context);
+        }
     }
     
     virtual ~MgShapeT()
     {
+        releaseContext();
     }
     
     GiContext* context()
     {
-        return &_context;
+        if (_style) {                           // 写时复制
+            ContextT* ctx = new ContextT();
+            static_cast<GiContext&>(*ctx) = _styles->getStyle(_style);
+            releaseContext();
+            _context = ctx;
+        }
+        return _context;
     }
     
     const GiContext* contextc() const
     {
-        return &_context;
+        return _style ? &_styles->getStyle(_style) : _context;
+    }
+    
+    //! 设置显示参数，图形列表写锁定时共享列表中的显示参数
+    /*! 派生的 ContextT 不共享，只设置其中的 GiContext 部分，其余成员不变 */
+    void setContext(const GiContext& ctx)
+    {
+        MgStyleTable* styles = stylesForWrite();
+        
+        if (styles) {
+            UInt32 style = styles->addStyle(ctx);   // 先添加再释放，ctx可能为原表项
+            releaseContext();
+            _styles = styles;
+            _style = style;
+        }
+        else if (_style) {
+            ContextT* p = new ContextT();
+            static_cast<GiContext&>(*p) = ctx;
+            releaseContext();
+            _context = p;
+        }
+        else {
+            static_cast<GiContext&>(*_context) = ctx;
+        }
+    }
+    
+    //! 返回显示参数是否为共享的
+    bool isSharedContext() const
+    {
+        return _style != 0;
     }
     
     MgBaseShape* shape()
@@ -59,6 +115,9 @@ public:
     
     bool draw(GiGraphics& gs, const GiContext *ctx = NULL) const
     {
+        if (!ctx)                               // 直接使用显示参数，不构造临时对象
+            return shapec()->draw(gs, *contextc());
+        
         ContextT tmpctx(getContext(gs, ctx));
         return shapec()->draw(gs, tmpctx);
     }
@@ -93,12 +152,15 @@ public:
         if (src.isKindOf(Type())) {
             const ThisClass& _src = (const ThisClass&)src;
             shape()->copy(_src._shape);
-            _context = _src._context;
             _tag = _src._tag;
             if (!_parent && 0 == _id) {
                 _parent = _src._parent;
                 _id = _src._id;
             }
+            if (MgStyleShareable<ContextT>::value)
+                setContext(*_src.contextc());
+            else                                // 复制派生类型的全部成员
+                *_context = *_src._context;
         }
         else if (src.isKindOf(ShapeT::Type())) {
             shape()->copy((const ShapeT&)src);
@@ -113,7 +175,7 @@ public:
         if (src.isKindOf(Type())) {
             const ThisClass& _src = (const ThisClass&)src;
             ret = shapec()->equals(_src._shape)
-            && _context == _src._context
+            && *contextc() == *_src.contextc()
             && _tag == _src._tag;
         }
         
@@ -134,6 +196,10 @@ public:
     {
         _parent = p;
         _id = nID;
+        
+        MgStyleTable* styles = stylesForWrite();
+        if (styles && (!_style || _styles != styles))
+            setContext(*contextc());
     }
 
     UInt32 getTag() const
@@ -148,40 +214,43 @@ public:
     
     bool save(MgStorage* s) const
     {
+        const GiContext& ctx = *contextc();
         GiColor c;
         
         s->writeUInt32("tag", _tag);
-        s->writeUInt8("lineStyle", (UInt8)_context.getLineStyle());
-        s->writeFloat("lineWidth", _context.getLineWidth());
+        s->writeUInt8("lineStyle", (UInt8)ctx.getLineStyle());
+        s->writeFloat("lineWidth", ctx.getLineWidth());
         
-        c = _context.getLineColor();
+        c = ctx.getLineColor();
         s->writeUInt32("lineColor", c.r | (c.g << 8) | (c.b << 16) | (c.a << 24));
-        c = _context.getFillColor();
+        c = ctx.getFillColor();
         s->writeUInt32("fillColor", c.r | (c.g << 8) | (c.b << 16) | (c.a << 24));
-        s->writeBool("autoFillColor", _context.isAutoFillColor());
+        s->writeBool("autoFillColor", ctx.isAutoFillColor());
         
         return shapec()->save(s);
     }
     
     bool load(MgStorage* s)
     {
+        GiContext ctx(*contextc());
         UInt32 c;
         
         _tag = s->readUInt32("tag", _tag);
-        _context.setLineStyle((GiLineStyle)s->readUInt8("lineStyle", 0));
-        _context.setLineWidth(s->readFloat("lineWidth", 0), true);
+        ctx.setLineStyle((GiLineStyle)s->readUInt8("lineStyle", 0));
+        ctx.setLineWidth(s->readFloat("lineWidth", 0), true);
         
         c = s->readUInt32("lineColor", 0xFF000000);
-        _context.setLineColor(GiColor((UInt8)(c & 0xFF), 
-                                      (UInt8)((c >> 8 ) & 0xFF), 
-                                      (UInt8)((c >> 16) & 0xFF), 
-                                      (UInt8)((c >> 24) & 0xFF)));
+        ctx.setLineColor(GiColor((UInt8)(c & 0xFF), 
+                                 (UInt8)((c >> 8 ) & 0xFF), 
+                                 (UInt8)((c >> 16) & 0xFF), 
+                                 (UInt8)((c >> 24) & 0xFF)));
         c = s->readUInt32("fillColor", 0);
-        _context.setFillColor(GiColor((UInt8)(c & 0xFF), 
-                                      (UInt8)((c >> 8 ) & 0xFF), 
-                                      (UInt8)((c >> 16) & 0xFF), 
-                                      (UInt8)((c >> 24) & 0xFF)));
-        _context.setAutoFillColor(s->readBool("autoFillColor", _context.isAutoFillColor()));
+        ctx.setFillColor(GiColor((UInt8)(c & 0xFF), 
+                                 (UInt8)((c >> 8 ) & 0xFF), 
+                                 (UInt8)((c >> 16) & 0xFF), 
+                                 (UInt8)((c >> 24) & 0xFF)));
+        ctx.setAutoFillColor(s->readBool("autoFillColor", ctx.isAutoFillColor()));
+        setContext(ctx);
         
         bool ret = shape()->load(s);
         if (ret) {
@@ -194,7 +263,12 @@ public:
 protected:
     ContextT getContext(GiGraphics& gs, const GiContext *ctx) const
     {
-        ContextT tmpctx(_context);
+        ContextT tmpctx;
+        
+        if (_style)
+            static_cast<GiContext&>(tmpctx) = *contextc();
+        else
+            tmpctx = *_context;                 // 保留派生类型的成员
         
         if (ctx && !ctx->isNullLine()) {
             float addw  = ctx->getLineWidth();
@@ -218,6 +292,36 @@ protected:
         
         return tmpctx;
     }
+    
+private:
+    void operator=(const ThisClass&);
+    
+    //! 返回可添加表项的共享显示参数表，表项只在图形列表写锁定时添加和释放
+    MgStyleTable* stylesForWrite() const
+    {
+        if (!MgStyleShareable<ContextT>::value || !_parent
+            || !_parent->getLockData()->lockedForWrite()) {
+            return NULL;
+        }
+        return _parent->getStyleTable();
+    }
+    
+    void releaseContext()
+    {
+        if (_style)
+            _styles->releaseStyle(_style);
+        else
+            delete _context;
+        _context = NULL;
+        _style = 0;
+    }
+    
+private:
+    union {
+        ContextT*       _context;       //!< 自有的显示参数，_style为0时有效
+        MgStyleTable*   _styles;        //!< 共享显示参数表，_style不为0时有效
+    };
+    UInt32      _style;                 //!< 共享显示参数的句柄，为0表示自有
 };
 
 #endif // __GEOMETRY_MGSHAPE_TEMPL_H_
@@ -0,0 +1,61 @@
+//! \file mgsorter.h
+//! \brief 定义按显示参数排序显示的辅助类 MgStyleSorter
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+
+#ifndef __GEOMETRY_MGSORTER_H_
+#define __GEOMETRY_MGSORTER_H_
+
+#include <mgshape.h>
+#include <gigraph.h>
+#include <vector>
+
+//! 按显示参数排序显示的辅助类
+/*! 在 GiGraphics::isStyleSorting() 为true时，图形列表的显示函数先用 add() 收集可见图形，
+    再调用 sort() 按显示参数将图形合并为若干批次，依次显示各批次的图形，
+    使显示参数相同的图形连续显示，减少画布的画笔和画刷切换。\n
+    一个图形只在与其后面的批次都不重叠时才能提前合并到参数相同的前面批次中，
+    因此重叠图形的上下次序不变，显示结果与不排序时一致。
+    \ingroup GEOM_SHAPE
+    \see GiGraphics::setStyleSorting
+*/
+class MgStyleSorter
+{
+public:
+    MgStyleSorter(GiGraphics& gs);
+
+    //! 返回是否需要排序显示，为false时应直接显示图形
+    bool enabled() const { return _enabled; }
+
+    //! 添加一个可见图形，按图形列表中的次序添加
+    void add(const MgShape* shape);
+
+    //! 排序，返回图形个数，并记录减少的参数切换次数
+    int sort();
+
+    //! 返回排序后指定序号的图形
+    const MgShape* getShape(int index) const { return _items[_order[index]].shape; }
+
+private:
+    enum { LOOKBACK = 32 };         //!< 向前查找相同参数的批次数
+
+    struct Item {
+        const MgShape*  shape;
+        Box2d           rect;       //!< 含线宽的显示范围
+        int             next;       //!< 同一批次中的下一个图形序号
+    };
+    struct Batch {
+        const GiContext* ctx;       //!< 批次的显示参数
+        Box2d           rect;       //!< 批次中各图形的显示范围
+        int             first;      //!< 批次中的第一个图形序号
+        int             last;       //!< 批次中的最后一个图形序号
+    };
+
+    GiGraphics&         _gs;
+    bool                _enabled;
+    std::vector<Item>   _items;
+    std::vector<Batch>  _batches;
+    std::vector<int>    _order;
+};
+
+#endif // __GEOMETRY_MGSORTER_H_
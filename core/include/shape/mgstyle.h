@@ -0,0 +1,75 @@
+//! \file mgstyle.h
+//! \brief 定义共享显示参数表类 MgStyleTable
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+
+#ifndef __GEOMETRY_MGSTYLE_H_
+#define __GEOMETRY_MGSTYLE_H_
+
+#include <gicontxt.h>
+#include <deque>
+#include <vector>
+#include <map>
+
+//! 共享显示参数表类
+/*! 每个图形列表有一个显示参数表，列表中显示参数相同的图形共享表中的同一项，
+    图形只保存表项的句柄，大量图形只用少数几种显示参数时可显著减少内存。\n
+    表项和本表都有引用计数，每个引用表项的句柄同时持有本表的一个引用，
+    因此从图形列表中移除的图形在列表销毁后仍可使用其显示参数。\n
+    添加和释放表项应在图形列表的写锁定范围内进行，查询表项可在多个线程中同时进行。
+    \ingroup GEOM_SHAPE
+    \see MgShapes::getStyleTable
+*/
+class MgStyleTable
+{
+public:
+    //! 创建一个空的显示参数表，引用计数为1
+    static MgStyleTable* create();
+
+    //! 增加本表的引用计数
+    void addRef();
+
+    //! 减少本表的引用计数，为0时销毁
+    void release();
+
+    //! 查找或添加显示参数，增加表项和本表的引用计数
+    /*!
+        \param ctx 显示参数
+        \return 表项的句柄，大于0
+    */
+    UInt32 addStyle(const GiContext& ctx);
+
+    //! 增加表项的引用计数，复制句柄时调用
+    void addStyleRef(UInt32 style);
+
+    //! 减少表项和本表的引用计数，表项引用计数为0时回收该表项
+    void releaseStyle(UInt32 style);
+
+    //! 返回表项的显示参数，句柄必须有效
+    const GiContext& getStyle(UInt32 style) const { return _entries[style - 1].ctx; }
+
+    //! 返回正在使用的表项个数
+    UInt32 getStyleCount() const { return (UInt32)(_entries.size() - _freeList.size()); }
+
+private:
+    MgStyleTable();
+    ~MgStyleTable();
+    MgStyleTable(const MgStyleTable&);
+    void operator=(const MgStyleTable&);
+
+    static UInt32 hashStyle(const GiContext& ctx);
+
+    struct Entry {
+        GiContext   ctx;
+        long        refcount;
+        UInt32      hash;
+    };
+    typedef std::multimap<UInt32, UInt32> Index;
+
+    volatile long           _refcount;
+    std::deque<Entry>       _entries;       //!< 表项，序号加1为句柄，地址不因添加而改变
+    std::vector<UInt32>     _freeList;      //!< 已回收的表项句柄
+    Index                   _index;         //!< 显示参数的散列值到句柄的索引
+};
+
+#endif // __GEOMETRY_MGSTYLE_H_
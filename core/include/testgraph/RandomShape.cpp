@@ -36,6 +36,13 @@ void RandomParam::setShapeProp(GiContext* context)
     context->setFillColor(GiColor(RandUInt8(0, 255), RandUInt8(0, 255), RandUInt8(0, 255), RandUInt8(32, 240)));
 }
 
+void RandomParam::setShapeProp(MgShape* shape)
+{
+    GiContext context(*shape->contextc());
+    setShapeProp(&context);
+    shape->setContext(context);     // 共享图形列表中的显示参数
+}
+
 void RandomParam::initShapes(MgShapes* shapes)
 {
     MgShapesLock locker(shapes, MgShapesLock::Load);
@@ -64,7 +71,7 @@ void RandomParam::initShapes(MgShapes* shapes)
             sp = shapes->addShape(shape);
             curveCount--;
             
-            setShapeProp(sp->context());
+            setShapeProp(sp);
             for (UInt32 i = 0; i < sp->shape()->getPointCount(); i++)
             {
                 if (0 == i)
@@ -84,7 +91,7 @@ void RandomParam::initShapes(MgShapes* shapes)
             arcCount--;
             /*
             ArcItem* shape = new ArcItem();
-            setShapeProp(sp->context());
+            setShapeProp(sp);
             shape->center.set(RandDbl(-1000, 1000), RandDbl(-1000, 1000));
             shape->rx = RandDbl(1, 1000);
             shape->ry = RandDbl(1, 1000);
@@ -101,7 +108,7 @@ void RandomParam::initShapes(MgShapes* shapes)
             sp = shapes->addShape(shape);
             rectCount--;
             
-            setShapeProp(sp->context());
+            setShapeProp(sp);
         }
         else
         {
@@ -113,7 +120,7 @@ void RandomParam::initShapes(MgShapes* shapes)
             MgShapeT<MgLine> shape;
 
             sp = shapes->addShape(shape);
-            setShapeProp(sp->context());
+            setShapeProp(sp);
             sp->shape()->setPoint(0, Point2d(RandF(-1000, 1000), RandF(-1000, 1000)));
             sp->shape()->setPoint(1, Point2d(RandF(-1000, 1000), RandF(-1000, 1000)));
         }
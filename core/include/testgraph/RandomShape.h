@@ -18,6 +18,7 @@ struct RandomParam
     long getShapeCount() const { return lineCount + rectCount + arcCount + curveCount; }
     void initShapes(MgShapes* shapes);
     void setShapeProp(GiContext* context);
+    void setShapeProp(MgShape* shape);
 
     static float RandF(float dMin, float dMax);
     static long RandInt(long nMin, long nMax);
@@ -0,0 +1,110 @@
+// cyclicbench.cpp: 比较闭合三次样条的循环三对角线解法与稠密矩阵解法
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+//
+// 由 src/geom/Makefile 的 bench 目标编译运行。对椭圆附近的随机型值点，
+// 分别用 mgCubicSplines(kMgCubicLoop)(即 mgCyclicTriEquations)和
+// mgGaussJordan 求解闭合样条的切矢量，输出耗时、两者的最大差和循环方程组的相对残差。
+// 相对残差超过 1e-4 或两种解法的结果不一致时返回非0。耗时与 libgeom.a 的编译选项有关。
+
+#include <mgcurv.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <vector>
+
+// 按 mgCubicSplines 修改前的方法构造稠密矩阵，用 Gauss-Jordan 法求解
+static bool denseLoopSplines(Int32 n, const Point2d* knots, Vector2d* vecs)
+{
+    std::vector<float> mat((size_t)n * n, 0.f);
+    float* a = &mat.front();
+    Int32 n1 = n - 1;
+
+    for (Int32 i = 0; i < n; i++) {
+        Int32 prev = (i + n1) % n, next = (i + 1) % n;
+
+        a[i * n + prev] = 1;
+        a[i * n + i] = 4;
+        a[i * n + next] = 1;
+        vecs[i] = (knots[next] - knots[prev]) * 3;
+    }
+
+    return mgGaussJordan(n, a, vecs);
+}
+
+// 循环方程组 v[i-1] + 4v[i] + v[i+1] = 3(P[i+1] - P[i-1]) 的最大相对残差
+static float loopResidual(Int32 n, const Point2d* knots, const Vector2d* vecs)
+{
+    float res = 0;
+
+    for (Int32 i = 0; i < n; i++) {
+        Int32 prev = (i + n - 1) % n, next = (i + 1) % n;
+        Vector2d rhs((knots[next] - knots[prev]) * 3);
+        Vector2d lhs(vecs[prev] + vecs[i] * 4 + vecs[next]);
+
+        res = mgMax(res, (lhs - rhs).length() / mgMax(rhs.length(), 1e-6f));
+    }
+
+    return res;
+}
+
+static double elapsedMs(clock_t start, int repeat)
+{
+    return (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC / repeat;
+}
+
+int main()
+{
+    const int counts[] = { 3, 10, 100, 512, 1000, 2000, 10000, 100000 };
+    int failed = 0;
+
+    srand(1);
+    printf("%8s %12s %12s %10s %10s\n", "n", "cyclic(ms)", "dense(ms)", "max|dv|", "residual");
+
+    for (size_t k = 0; k < sizeof(counts) / sizeof(counts[0]); k++) {
+        const int n = counts[k];
+        std::vector<Point2d> knots(n);
+        std::vector<Vector2d> v1(n), v2(n);
+
+        for (Int32 i = 0; i < n; i++) {
+            float t = _M_2PI * i / n;
+            knots[i].set(500 * cosf(t) + rand() % 20, 400 * sinf(t) + rand() % 20);
+        }
+
+        int repeat = mgMax(1, 200000 / n);     // 小规模时重复多次，减小计时误差
+        clock_t start = clock();
+        bool ret = true;
+
+        for (int r = 0; r < repeat; r++)
+            ret = mgCubicSplines(n, &knots.front(), &v1.front(), kMgCubicLoop) && ret;
+
+        double cyclicMs = elapsedMs(start, repeat);
+        float residual = loopResidual(n, &knots.front(), &v1.front());
+        float maxdiff = 0;
+
+        if (!ret || residual > 1e-4f)
+            failed++;
+
+        if (n <= 1000) {                        // 稠密解法为O(n^3)，规模再大时太慢
+            repeat = mgMax(1, 2000 / (n * n));
+            start = clock();
+            for (int r = 0; r < repeat; r++)
+                ret = denseLoopSplines(n, &knots.front(), &v2.front());
+
+            double denseMs = elapsedMs(start, repeat);
+            for (Int32 i = 0; i < n; i++)
+                maxdiff = mgMax(maxdiff, (v1[i] - v2[i]).length());
+            if (!ret || maxdiff > 1e-3f * 500)
+                failed++;
+
+            printf("%8d %12.4f %12.3f %10.2e %10.2e\n", n, cyclicMs, denseMs, maxdiff, residual);
+        }
+        else {
+            printf("%8d %12.4f %12s %10s %10.2e\n", n, cyclicMs, "-", "-", residual);
+        }
+    }
+
+    printf(failed ? "FAILED\n" : "OK\n");
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,184 @@
+// mgarclen.cpp: 实现折线和多段贝塞尔曲线的弧长表类 MgArcLength
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+
+#include "mgarclen.h"
+
+MgArcLength::MgArcLength()
+    : _segments(0), _count(0), _capacity(0), _params(NULL), _lengths(NULL)
+{
+}
+
+MgArcLength::~MgArcLength()
+{
+    clear();
+}
+
+void MgArcLength::clear()
+{
+    delete[] _params;
+    delete[] _lengths;
+    _params = NULL;
+    _lengths = NULL;
+    _segments = _count = _capacity = 0;
+}
+
+void MgArcLength::addSample(float t, float length)
+{
+    if (_count == _capacity) {
+        _capacity = mgMax(_capacity * 2, (Int32)64);
+
+        float* params = new float[_capacity];
+        float* lengths = new float[_capacity];
+
+        for (Int32 i = 0; i < _count; i++) {
+            params[i] = _params[i];
+            lengths[i] = _lengths[i];
+        }
+        delete[] _params;
+        delete[] _lengths;
+        _params = params;
+        _lengths = lengths;
+    }
+    _params[_count] = t;
+    _lengths[_count++] = length;
+}
+
+void MgArcLength::buildLines(Int32 count, const Point2d* points, bool closed)
+{
+    clear();
+    if (count < 2 || !points)
+        return;
+
+    _segments = closed ? count : count - 1;
+
+    float len = 0;
+
+    addSample(0, 0);
+    for (Int32 i = 0; i < _segments; i++) {
+        len += points[i].distanceTo(points[(i + 1) % count]);
+        addSample((float)(i + 1), len);
+    }
+}
+
+// 控制多边形长度与弦长的加权平均，误差随细分以四次方减小(Gravesen)
+static inline float bezierLength(const Point2d* pts, float& flatness)
+{
+    float chord = pts[0].distanceTo(pts[3]);
+    float poly = pts[0].distanceTo(pts[1]) + pts[1].distanceTo(pts[2])
+        + pts[2].distanceTo(pts[3]);
+
+    flatness = poly - chord;
+    return (2 * chord + poly) / 3;
+}
+
+// 用 de Casteljau 算法在中点处分为两段
+static void splitBezier(const Point2d* pts, Point2d* left, Point2d* right)
+{
+    Point2d p01((pts[0] + pts[1]) / 2);
+    Point2d p12((pts[1] + pts[2]) / 2);
+    Point2d p23((pts[2] + pts[3]) / 2);
+    Point2d p012((p01 + p12) / 2);
+    Point2d p123((p12 + p23) / 2);
+    Point2d mid((p012 + p123) / 2);
+
+    left[0] = pts[0]; left[1] = p01; left[2] = p012; left[3] = mid;
+    right[0] = mid; right[1] = p123; right[2] = p23; right[3] = pts[3];
+}
+
+void MgArcLength::addBezier(Int32 segment, const Point2d* pts, float t0, float t1,
+                            float len, float tol, int depth)
+{
+    Point2d left[4], right[4];
+    float flat1, flat2;
+
+    splitBezier(pts, left, right);
+
+    float len1 = bezierLength(left, flat1);
+    float len2 = bezierLength(right, flat2);
+    float tm = (t0 + t1) / 2;
+
+    // 两半都足够平直且长度相近时，参数和弧长在两半内都近似线性，记下中点和终点
+    if (depth >= MAX_DEPTH || (flat1 <= tol && flat2 <= tol
+                               && fabsf(len1 - len2) <= tol
+                               && fabsf(len1 + len2 - len) <= tol)) {
+        float base = _lengths[_count - 1];
+        addSample(segment + tm, base + len1);
+        addSample(segment + t1, base + len1 + len2);
+    }
+    else {
+        addBezier(segment, left, t0, tm, len1, tol, depth + 1);
+        addBezier(segment, right, tm, t1, len2, tol, depth + 1);
+    }
+}
+
+void MgArcLength::buildBeziers(Int32 count, const Point2d* points, float tol)
+{
+    clear();
+    if (count < 4 || !points)
+        return;
+
+    _segments = (count - 1) / 3;
+
+    float flatness;
+
+    addSample(0, 0);
+    for (Int32 i = 0; i < _segments; i++) {
+        const Point2d* pts = points + 3 * i;
+        addBezier(i, pts, 0, 1, bezierLength(pts, flatness), mgMax(tol, _MGZERO), 0);
+    }
+}
+
+// 在从小到大排列的数组中查找 values[i] <= value < values[i+1] 的i
+static Int32 findInterval(const float* values, Int32 count, float value)
+{
+    Int32 lo = 0, hi = count - 1;
+
+    while (hi - lo > 1) {
+        Int32 mid = (lo + hi) / 2;
+        if (values[mid] <= value)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+float MgArcLength::lengthAt(float t) const
+{
+    if (_count < 2 || t <= 0)
+        return 0;
+    if (t >= _params[_count - 1])
+        return getLength();
+
+    Int32 i = findInterval(_params, _count, t);
+    float dt = _params[i + 1] - _params[i];
+
+    return _lengths[i] + (dt > 0 ? (t - _params[i]) / dt : 0) * (_lengths[i + 1] - _lengths[i]);
+}
+
+float MgArcLength::paramAt(float length) const
+{
+    if (_count < 2 || length <= 0)
+        return 0;
+    if (length >= getLength())
+        return _params[_count - 1];
+
+    Int32 i = findInterval(_lengths, _count, length);
+    float dl = _lengths[i + 1] - _lengths[i];
+
+    return _params[i] + (dl > 0 ? (length - _lengths[i]) / dl : 0) * (_params[i + 1] - _params[i]);
+}
+
+Int32 MgArcLength::splitParam(float t, float& u) const
+{
+    if (_segments < 1) {
+        u = 0;
+        return 0;
+    }
+
+    Int32 segment = mgMin(mgMax((Int32)floorf(t), (Int32)0), _segments - 1);
+
+    u = mgMin(mgMax(t - segment, 0.f), 1.f);
+    return segment;
+}
@@ -0,0 +1,83 @@
+// mgbatch.cpp: 实现成批计算绑定框的函数
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+
+#include "mgbatch.h"
+
+// 定义 MG_NO_SIMD 可强制使用逐个计算的实现
+#if !defined(MG_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define MG_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+// Point2d 为连续的两个 float，一个SSE寄存器可放两个点 (x0,y0,x1,y1)，不需要转置为 SoA
+
+GEOMAPI void mgPointsBox(Int32 count, const Point2d* points, Box2d& box)
+{
+    if (count < 1 || !points) {
+        box.empty();
+        return;
+    }
+
+    float xmin = points[0].x, ymin = points[0].y;
+    float xmax = xmin, ymax = ymin;
+    Int32 i = 1;
+
+#ifdef MG_USE_SSE2
+    if (count >= 5) {
+        __m128 mn = _mm_loadu_ps(&points[0].x);
+        __m128 mx = mn;
+
+        for (i = 2; i + 1 < count; i += 2) {
+            __m128 v = _mm_loadu_ps(&points[i].x);
+            mn = _mm_min_ps(mn, v);
+            mx = _mm_max_ps(mx, v);
+        }
+        mn = _mm_min_ps(mn, _mm_movehl_ps(mn, mn));     // 合并两个点的分量
+        mx = _mm_max_ps(mx, _mm_movehl_ps(mx, mx));
+
+        float tmp[4];
+        _mm_storel_pi((__m64*)tmp, mn);
+        _mm_storel_pi((__m64*)(tmp + 2), mx);
+        xmin = tmp[0]; ymin = tmp[1];
+        xmax = tmp[2]; ymax = tmp[3];
+    }
+#endif
+    for (; i < count; i++) {
+        xmin = mgMin(xmin, points[i].x);
+        ymin = mgMin(ymin, points[i].y);
+        xmax = mgMax(xmax, points[i].x);
+        ymax = mgMax(ymax, points[i].y);
+    }
+
+    box.xmin = xmin; box.ymin = ymin;
+    box.xmax = xmax; box.ymax = ymax;
+}
+
+GEOMAPI void mgLineBoxes(Int32 count, const Point2d* points, Box2d* boxes)
+{
+    Int32 i = 0;
+
+#ifdef MG_USE_SSE2
+    // 起点 (x0,y0,x1,y1) 和终点 (x1,y1,x2,y2) 的最小最大值即为相邻两段的绑定框
+    for (; i + 2 < count; i += 2) {
+        __m128 s = _mm_loadu_ps(&points[i].x);
+        __m128 e = _mm_loadu_ps(&points[i + 1].x);
+        __m128 mn = _mm_min_ps(s, e);
+        __m128 mx = _mm_max_ps(s, e);
+
+        _mm_storeu_ps(&boxes[i].xmin, _mm_movelh_ps(mn, mx));
+        _mm_storeu_ps(&boxes[i + 1].xmin, _mm_movehl_ps(mx, mn));
+    }
+#endif
+    for (; i + 1 < count; i++) {
+        const Point2d& p1 = points[i];
+        const Point2d& p2 = points[i + 1];
+
+        boxes[i].xmin = mgMin(p1.x, p2.x);
+        boxes[i].ymin = mgMin(p1.y, p2.y);
+        boxes[i].xmax = mgMax(p1.x, p2.x);
+        boxes[i].ymax = mgMax(p1.y, p2.y);
+    }
+}
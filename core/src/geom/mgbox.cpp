@@ -4,6 +4,7 @@
 
 #include "mgbox.h"
 #include "mgmat.h"
+#include "mgbatch.h"
 
 Box2d::Box2d(const BOX_2D& src, bool bNormalize)
 {
@@ -63,18 +64,7 @@ Box2d& Box2d::set(int count, const Point2d* points)
     if (count < 1 || !points)
         return empty();
 
-    set(points[0], points[0]);
-    for (int i = 0; i < count; i++)
-    {
-        if (xmin > points[i].x)
-            xmin = points[i].x;
-        if (ymin > points[i].y)
-            ymin = points[i].y;
-        if (xmax < points[i].x)
-            xmax = points[i].x;
-        if (ymax < points[i].y)
-            ymax = points[i].y;
-    }
+    mgPointsBox(count, points, *this);
     if (isEmpty())
         inflate(Tol::gTol().equalPoint());
 
@@ -0,0 +1,230 @@
+// mgcross.cpp: 实现线段集合求交的网格索引类 MgCrossGrid
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+
+#include "mgcross.h"
+#include "mglnrel.h"
+
+MgCrossGrid::MgCrossGrid()
+    : _count(0), _pts(NULL), _nx(0), _ny(0), _cw(1), _ch(1)
+    , _cellStart(NULL), _cellSegs(NULL), _marks(NULL), _mark(0)
+{
+}
+
+MgCrossGrid::~MgCrossGrid()
+{
+    clear();
+}
+
+void MgCrossGrid::clear()
+{
+    delete[] _pts;
+    delete[] _cellStart;
+    delete[] _cellSegs;
+    delete[] _marks;
+    _pts = NULL;
+    _cellStart = NULL;
+    _cellSegs = NULL;
+    _marks = NULL;
+    _count = 0;
+    _nx = _ny = 0;
+    _mark = 0;
+    _extent.empty();
+}
+
+// 依次访问线段穿过的各个网格，每行只计算线段在该行内的X范围，长的斜线不会占用其绑定框内的所有网格
+template <class Op>
+void MgCrossGrid::walk(const Point2d& a, const Point2d& b, Op& op) const
+{
+    Box2d box(a, b);
+    float eps = mgMax(_cw, _ch) * 1e-3f;    // 网格边界处的交点可能因舍入误差落在相邻网格
+
+    if (_count < 1 || box.xmax < _extent.xmin - eps || box.xmin > _extent.xmax + eps
+        || box.ymax < _extent.ymin - eps || box.ymin > _extent.ymax + eps) {
+        return;
+    }
+
+    Int32 j0 = (Int32)floorf((box.ymin - eps - _extent.ymin) / _ch);
+    Int32 j1 = (Int32)floorf((box.ymax + eps - _extent.ymin) / _ch);
+
+    j0 = mgMax(j0, (Int32)0);
+    j1 = mgMin(j1, _ny - 1);
+
+    for (Int32 j = j0; j <= j1; j++) {
+        float y0 = mgMax(_extent.ymin + j * _ch - eps, box.ymin);
+        float y1 = mgMin(_extent.ymin + (j + 1) * _ch + eps, box.ymax);
+        float x0 = box.xmin, x1 = box.xmax;
+
+        if (a.y != b.y) {
+            float k = (b.x - a.x) / (b.y - a.y);
+            x0 = a.x + (y0 - a.y) * k;
+            x1 = a.x + (y1 - a.y) * k;
+            if (x0 > x1)
+                mgSwap(x0, x1);
+            x0 = mgMax(x0, box.xmin);
+            x1 = mgMin(x1, box.xmax);
+        }
+
+        Int32 i0 = (Int32)floorf((x0 - eps - _extent.xmin) / _cw);
+        Int32 i1 = (Int32)floorf((x1 + eps - _extent.xmin) / _cw);
+
+        i0 = mgMax(i0, (Int32)0);
+        i1 = mgMin(i1, _nx - 1);
+        for (Int32 i = i0; i <= i1; i++) {
+            op(j * _nx + i);
+        }
+    }
+}
+
+struct CountCellOp {
+    Int32* counts;
+    void operator()(Int32 cell) { counts[cell + 1]++; }
+};
+
+struct FillCellOp {
+    Int32* next;
+    Int32* segs;
+    Int32 seg;
+    void operator()(Int32 cell) { segs[next[cell]++] = seg; }
+};
+
+void MgCrossGrid::build(Int32 count, const Point2d* pts)
+{
+    clear();
+    if (count < 1 || !pts)
+        return;
+
+    _count = count;
+    _pts = new Point2d[count * 2];
+    _marks = new Int32[count];
+    for (Int32 i = 0; i < count * 2; i++) {
+        _pts[i] = pts[i];
+    }
+    for (Int32 i = 0; i < count; i++) {
+        _marks[i] = 0;
+    }
+    _extent.set(count * 2, _pts);
+
+    // 网格总数约为线段数，网格尽量接近正方形
+    float w = _extent.width();
+    float h = _extent.height();
+
+    if (w > _MGZERO && h > _MGZERO) {
+        _nx = (Int32)ceilf(sqrtf(count * w / h));
+        _ny = (Int32)ceilf(sqrtf(count * h / w));
+    }
+    else {
+        _nx = w > _MGZERO ? count : 1;
+        _ny = h > _MGZERO ? count : 1;
+    }
+    _nx = mgMax(mgMin(_nx, (Int32)MAX_CELLS), (Int32)1);
+    _ny = mgMax(mgMin(_ny, (Int32)MAX_CELLS), (Int32)1);
+    _cw = w > _MGZERO ? w / _nx : 1.f;
+    _ch = h > _MGZERO ? h / _ny : 1.f;
+
+    // 先统计每个网格的线段数，再依次填入线段序号
+    Int32 ncells = _nx * _ny;
+    Int32 i;
+
+    _cellStart = new Int32[ncells + 1];
+    for (i = 0; i <= ncells; i++) {
+        _cellStart[i] = 0;
+    }
+
+    CountCellOp countop = { _cellStart };
+    for (i = 0; i < count; i++) {
+        walk(_pts[2 * i], _pts[2 * i + 1], countop);
+    }
+    for (i = 0; i < ncells; i++) {
+        _cellStart[i + 1] += _cellStart[i];
+    }
+
+    Int32* next = new Int32[ncells];
+    for (i = 0; i < ncells; i++) {
+        next[i] = _cellStart[i];
+    }
+    _cellSegs = new Int32[mgMax(_cellStart[ncells], (Int32)1)];
+
+    FillCellOp fillop = { next, _cellSegs, 0 };
+    for (i = 0; i < count; i++) {
+        fillop.seg = i;
+        walk(_pts[2 * i], _pts[2 * i + 1], fillop);
+    }
+    delete[] next;
+}
+
+Int32 MgCrossGrid::nextMark() const
+{
+    if (++_mark == 0x7FFFFFFF) {        // 标记用完后重新开始
+        for (Int32 i = 0; i < _count; i++) {
+            _marks[i] = 0;
+        }
+        _mark = 1;
+    }
+    return _mark;
+}
+
+struct CrossCellOp {
+    const Point2d*  pts;
+    const Int32*    cellStart;
+    const Int32*    cellSegs;
+    Int32*          marks;
+    Int32           mark;
+    Int32           seg;        // 集合中的线段序号，给定任意线段时为-1
+    Point2d         a, b;
+    MgCrossFound    found;
+    void*           data;
+    Int32           count;
+    bool            stopped;
+
+    void operator()(Int32 cell) {
+        Point2d pt;
+
+        for (Int32 k = cellStart[cell]; k < cellStart[cell + 1] && !stopped; k++) {
+            Int32 other = cellSegs[k];
+
+            if (other <= seg || marks[other] == mark)   // 每对线段只测试一次
+                continue;
+            marks[other] = mark;
+
+            const Point2d& c = pts[2 * other];
+            const Point2d& d = pts[2 * other + 1];
+            bool crossed = seg < 0 ? mgCross2Line(c, d, a, b, pt)
+                                   : mgCross2Line(a, b, c, d, pt);
+            if (crossed) {
+                count++;
+                if (found) {
+                    stopped = seg < 0 ? !found(data, other, -1, pt)
+                                      : !found(data, seg, other, pt);
+                }
+            }
+        }
+    }
+};
+
+Int32 MgCrossGrid::findAll(MgCrossFound found, void* data) const
+{
+    CrossCellOp op = { _pts, _cellStart, _cellSegs, _marks, 0, 0,
+        Point2d(), Point2d(), found, data, 0, false };
+
+    for (Int32 i = 0; i < _count && !op.stopped; i++) {
+        op.mark = nextMark();
+        op.seg = i;
+        op.a = _pts[2 * i];
+        op.b = _pts[2 * i + 1];
+        walk(op.a, op.b, op);
+    }
+
+    return op.count;
+}
+
+Int32 MgCrossGrid::findCross(const Point2d& a, const Point2d& b,
+                             MgCrossFound found, void* data) const
+{
+    CrossCellOp op = { _pts, _cellStart, _cellSegs, _marks, nextMark(), -1,
+        a, b, found, data, 0, false };
+
+    walk(a, b, op);
+
+    return op.count;
+}
@@ -106,7 +106,7 @@ GEOMAPI void mgRoundRectToBeziers(
         float dx1 = (0 == i || 3 == i) ? dx : -dx;
         float dy1 = (0 == i || 1 == i) ? dy : -dy;
         for (j = 0; j < 4; j++)
-            points[0 ].offset(dx1, dy1);
+            points[4 * i + j].offset(dx1, dy1);
     }
 }
 
@@ -389,6 +389,73 @@ GEOMAPI bool mgTriEquations(
     return true;
 }
 
+GEOMAPI bool mgCyclicTriEquations(
+    Int32 n, const float *a, const float *b, const float *c,
+    float alpha, float beta, Vector2d *vs)
+{
+    if (!a || !b || !c || !vs || n < 3 || mgIsZero(b[0]))
+        return false;
+    
+    // 令 A = T + u * v', u = (gamma,0,...,0,alpha), v = (1,0,...,0,beta/gamma)，
+    // 分别求解 T * x = r 和 T * z = u，则 A 的解为 x - z * (v'x) / (1 + v'z)
+    const float gamma = -b[0];
+    float* cp = new float[n * 2];   // 消元后的右对角线元素
+    float* z = cp + n;
+    float w, bi;
+    Int32 i;
+    
+    if (!cp)
+        return false;
+    
+    w = 1 / (b[0] - gamma);
+    cp[0] = c[0] * w;
+    vs[0].x *= w;
+    vs[0].y *= w;
+    z[0] = gamma * w;
+    
+    for (i = 1; i < n; i++)
+    {
+        bi = (i < n - 1) ? b[i] : b[i] - alpha * beta / gamma;
+        w = bi - a[i-1] * cp[i-1];
+        if (mgIsZero(w))
+            break;
+        w = 1 / w;
+        cp[i] = (i < n - 1) ? c[i] * w : 0.f;
+        vs[i].x = (vs[i].x - a[i-1] * vs[i-1].x) * w;
+        vs[i].y = (vs[i].y - a[i-1] * vs[i-1].y) * w;
+        z[i] = ((i < n - 1 ? 0.f : alpha) - a[i-1] * z[i-1]) * w;
+    }
+    
+    bool ret = (i == n);
+    
+    if (ret)
+    {
+        for (i = n-2; i >= 0; i--)
+        {
+            vs[i].x -= cp[i] * vs[i+1].x;
+            vs[i].y -= cp[i] * vs[i+1].y;
+            z[i] -= cp[i] * z[i+1];
+        }
+        
+        w = 1 + z[0] + beta * z[n-1] / gamma;
+        ret = !mgIsZero(w);
+    }
+    if (ret)
+    {
+        float fx = (vs[0].x + beta * vs[n-1].x / gamma) / w;
+        float fy = (vs[0].y + beta * vs[n-1].y / gamma) / w;
+        
+        for (i = 0; i < n; i++)
+        {
+            vs[i].x -= fx * z[i];
+            vs[i].y -= fy * z[i];
+        }
+    }
+    delete[] cp;
+    
+    return ret;
+}
+
 GEOMAPI bool mgGaussJordan(Int32 n, float *mat, Vector2d *vs)
 {
     Int32 i, j, k, m;
@@ -453,34 +520,26 @@ GEOMAPI bool mgGaussJordan(Int32 n, float *mat, Vector2d *vs)
 }
 
 static bool CalcCubicClosed(
-    Int32 n, float* a, Vector2d* vecs, const Point2d* knots)
+    Int32 n, float* a, float* b, float* c, Vector2d* vecs, const Point2d* knots)
 {
     Int32 i, n1 = n - 1;
-
-    for (i = n*n - 1; i >= 0; i--)
-        a[i] = 0.f;
-    
-    a[n1] = 1.0;
-    a[0]  = 4.0;
-    a[1]  = 1.0;
-    a[n1*n+n1 - 1] = 1.0;
-    a[n1*n+n1]   = 4.0;
-    a[n1*n+0]    = 1.0;
-    vecs[0].x  = 3 * (knots[1].x-knots[n1].x);
-    vecs[0].y  = 3 * (knots[1].y-knots[n1].y);
-    vecs[n1].x = 3 * (knots[0].x-knots[n1 - 1].x);
-    vecs[n1].y = 3 * (knots[0].y-knots[n1 - 1].y);
-    
-    for (i = 1; i < n1; i++)
-    {
-        a[i*n+i-1] = 1.0;
-        a[i*n+i]   = 4.0;
-        a[i*n+i+1] = 1.0;
-        vecs[i].x = 3 * (knots[i+1].x-knots[i-1].x);
-        vecs[i].y = 3 * (knots[i+1].y-knots[i-1].y);
+    
+    for (i = 0; i < n; i++)
+    {
+        const Point2d& prev = knots[i > 0 ? i - 1 : n1];
+        const Point2d& next = knots[i < n1 ? i + 1 : 0];
+        
+        a[i] = 1.0;
+        b[i] = 4.0;
+        c[i] = 1.0;
+        vecs[i].x = 3 * (next.x - prev.x);
+        vecs[i].y = 3 * (next.y - prev.y);
     }
     
-    return mgGaussJordan(n, a, vecs);
+    if (n < 3)                      // 两点时首末行的左右元素重合
+        return mgTriEquations(n, a, b, c, vecs);
+    
+    return mgCyclicTriEquations(n, a, b, c, 1.0, 1.0, vecs);
 }
 
 static bool CalcCubicUnclosed(
@@ -550,10 +609,10 @@ GEOMAPI bool mgCubicSplines(
     if (!knots || !knotvs || n < 2)
         return false;
     
-    if ((flag & kMgCubicLoop) && n <= 512)    // 闭合
+    if (flag & kMgCubicLoop)        // 闭合
     {
-        float* a = new float[n * n];
-        ret = a && CalcCubicClosed(n, a, knotvs, knots);
+        float* a = new float[n * 3];
+        ret = a && CalcCubicClosed(n, a, a+n, a+2*n, knotvs, knots);
         delete[] a;
     }
     else
@@ -605,6 +664,343 @@ GEOMAPI void mgCubicSplineToBezier(
     points[3] = knots[i2];
 }
 
+GEOMAPI Int32 mgBezierSegments(const Point2d* pts, float tol)
+{
+    // Wang 公式: n = sqrt(d(d-1)/8 * max|P[i]-2P[i+1]+P[i+2]| / tol), d=3
+    float d1 = mgHypot(pts[0].x - 2 * pts[1].x + pts[2].x, 
+                       pts[0].y - 2 * pts[1].y + pts[2].y);
+    float d2 = mgHypot(pts[1].x - 2 * pts[2].x + pts[3].x, 
+                       pts[1].y - 2 * pts[2].y + pts[3].y);
+    float n = sqrtf(0.75f * mgMax(d1, d2) / mgMax(tol, 1e-4f));
+
+    return n < 1.f ? 1 : (n > 1023.f ? 1024 : (Int32)ceilf(n));
+}
+
+// 用前向差分计算贝塞尔曲线段上n个等参数点(不含起点)
+static void flattenBezier(Point2d* pxs, Int32 n, const Point2d* pts)
+{
+    const float h = 1.f / n;
+    const float h2 = h * h;
+    const float h3 = h2 * h;
+    
+    // B(t) = a*t^3 + b*t^2 + c*t + P0
+    float ax = -pts[0].x + 3 * (pts[1].x - pts[2].x) + pts[3].x;
+    float ay = -pts[0].y + 3 * (pts[1].y - pts[2].y) + pts[3].y;
+    float bx = 3 * (pts[0].x - 2 * pts[1].x + pts[2].x);
+    float by = 3 * (pts[0].y - 2 * pts[1].y + pts[2].y);
+    float cx = 3 * (pts[1].x - pts[0].x);
+    float cy = 3 * (pts[1].y - pts[0].y);
+    
+    float x = pts[0].x, y = pts[0].y;
+    float dx = ax * h3 + bx * h2 + cx * h;
+    float dy = ay * h3 + by * h2 + cy * h;
+    float ddx = 6 * ax * h3 + 2 * bx * h2;
+    float ddy = 6 * ay * h3 + 2 * by * h2;
+    const float dddx = 6 * ax * h3;
+    const float dddy = 6 * ay * h3;
+    
+    for (Int32 i = 1; i < n; i++)
+    {
+        x += dx;
+        y += dy;
+        dx += ddx;
+        dy += ddy;
+        ddx += dddx;
+        ddy += dddy;
+        pxs[i - 1].set(x, y);
+    }
+    pxs[n - 1] = pts[3];                        // 终点不累积误差
+}
+
+GEOMAPI Int32 mgBeziersToLines(
+    Point2d* pxs, Int32 maxCount, Int32 count, const Point2d* pts, float tol)
+{
+    if (count < 4 || pts == NULL)
+        return 0;
+    if (pxs == NULL)
+        maxCount = 0;
+    
+    Int32 total = 1;
+    Point2d tmp[1024];
+
+    if (maxCount > 0)
+        pxs[0] = pts[0];
+    for (Int32 i = 0; i + 3 < count; i += 3)
+    {
+        Int32 n = mgBezierSegments(pts + i, tol);
+        
+        if (total + n <= maxCount) {
+            flattenBezier(pxs + total, n, pts + i);
+        }
+        else if (total < maxCount) {            // 只输出容量内的部分
+            flattenBezier(tmp, n, pts + i);
+            for (Int32 j = 0; total + j < maxCount; j++)
+                pxs[total + j] = tmp[j];
+        }
+        total += n;
+    }
+    
+    return total;
+}
+
+GEOMAPI Int32 mgCubicSplinesToLines(
+    Point2d* pxs, Int32 maxCount, Int32 n, const Point2d* knots,
+    const Vector2d* knotvs, bool closed, float tol)
+{
+    if (n < 2 || knots == NULL || knotvs == NULL)
+        return 0;
+    
+    Int32 total = 0;
+    Int32 count = closed ? n : n - 1;
+    Point2d pts[4];
+    
+    if (pxs == NULL)
+        maxCount = 0;
+    for (Int32 i = 0; i < count; i++)
+    {
+        Int32 len = i > 0 ? total - 1 : 0;      // 各段首尾相接
+
+        mgCubicSplineToBezier(n, knots, knotvs, i, pts);
+        total = len + mgBeziersToLines(len < maxCount ? pxs + len : NULL,
+            mgMax(maxCount - len, (Int32)0), 4, pts, tol);
+    }
+    
+    return total;
+}
+
+// 曲线拟合用的公共数据
+struct FitBeziersData {
+    const Point2d*  pts;
+    float*          u;          // 各点在当前段的参数
+    float           tol;
+    Point2d*        out;
+    Int32*          indexes;
+    Int32           count;      // 已输出的控制点数
+};
+
+// 按弦长计算 pts[first..last] 的参数
+static void chordLengthParams(const Point2d* pts, Int32 first, Int32 last, float* u)
+{
+    u[first] = 0;
+    for (Int32 i = first + 1; i <= last; i++)
+        u[i] = u[i - 1] + pts[i].distanceTo(pts[i - 1]);
+    
+    float len = u[last];
+    for (Int32 i = first + 1; i <= last; i++)
+        u[i] = len > _MGZERO ? u[i] / len : (float)(i - first) / (last - first);
+}
+
+// 端点和切向已知，用最小二乘法计算贝塞尔曲线段两个中间控制点到端点的距离
+static void generateBezier(const FitBeziersData& d, Int32 first, Int32 last,
+                           const Vector2d& tan1, const Vector2d& tan2, Point2d bz[4])
+{
+    const Point2d& p0 = d.pts[first];
+    const Point2d& p3 = d.pts[last];
+    float c00 = 0, c01 = 0, c11 = 0, x0 = 0, x1 = 0;
+    
+    for (Int32 i = first; i <= last; i++) {
+        float t = d.u[i], v = 1 - t;
+        float b0 = v * v * v, b1 = 3 * t * v * v, b2 = 3 * t * t * v, b3 = t * t * t;
+        Vector2d a1(tan1 * b1);
+        Vector2d a2(tan2 * b2);
+        Vector2d tmp(d.pts[i].x - (p0.x * (b0 + b1) + p3.x * (b2 + b3)),
+                     d.pts[i].y - (p0.y * (b0 + b1) + p3.y * (b2 + b3)));
+        
+        c00 += a1.dotProduct(a1);
+        c01 += a1.dotProduct(a2);
+        c11 += a2.dotProduct(a2);
+        x0 += a1.dotProduct(tmp);
+        x1 += a2.dotProduct(tmp);
+    }
+    
+    float det = c00 * c11 - c01 * c01;
+    float seglen = p0.distanceTo(p3);
+    float alpha1 = mgIsZero(det) ? 0.f : (x0 * c11 - x1 * c01) / det;
+    float alpha2 = mgIsZero(det) ? 0.f : (c00 * x1 - c01 * x0) / det;
+    
+    if (alpha1 < seglen * 1e-3f || alpha2 < seglen * 1e-3f) {
+        alpha1 = alpha2 = seglen / 3;       // 无解或反向时按弦长的1/3取控制点
+    }
+    bz[0] = p0;
+    bz[1] = p0 + tan1 * alpha1;
+    bz[2] = p3 + tan2 * alpha2;
+    bz[3] = p3;
+}
+
+// 返回各点到参数点的最大距离及其序号
+static float computeMaxError(const FitBeziersData& d, Int32 first, Int32 last,
+                             const Point2d bz[4], Int32& split)
+{
+    float maxdist = 0;
+    Point2d pt;
+    
+    split = (first + last) / 2;
+    for (Int32 i = first + 1; i < last; i++) {
+        mgFitBezier(bz, d.u[i], pt);
+        float dist = pt.distanceTo(d.pts[i]);
+        if (maxdist < dist) {
+            maxdist = dist;
+            split = i;
+        }
+    }
+    
+    return maxdist;
+}
+
+// 用牛顿迭代法修正各点的参数，使参数点更接近该点
+static void reparameterize(const FitBeziersData& d, Int32 first, Int32 last, const Point2d bz[4])
+{
+    Vector2d d1[3] = { (bz[1] - bz[0]) * 3, (bz[2] - bz[1]) * 3, (bz[3] - bz[2]) * 3 };
+    Vector2d d2[2] = { (d1[1] - d1[0]) * 2, (d1[2] - d1[1]) * 2 };
+    
+    for (Int32 i = first + 1; i < last; i++) {
+        float t = d.u[i], v = 1 - t;
+        Point2d pt;
+        mgFitBezier(bz, t, pt);
+        
+        Vector2d q1(d1[0] * (v * v) + d1[1] * (2 * t * v) + d1[2] * (t * t));
+        Vector2d q2(d2[0] * v + d2[1] * t);
+        Vector2d diff(pt - d.pts[i]);
+        float den = q1.dotProduct(q1) + diff.dotProduct(q2);
+        
+        if (!mgIsZero(den)) {
+            d.u[i] = mgMax(0.f, mgMin(1.f, t - diff.dotProduct(q1) / den));
+        }
+    }
+}
+
+static void addBezier(FitBeziersData& d, Int32 last, const Point2d bz[4])
+{
+    if (d.count == 0)
+        d.out[d.count++] = bz[0];
+    d.out[d.count++] = bz[1];
+    d.out[d.count++] = bz[2];
+    d.out[d.count++] = bz[3];
+    if (d.indexes)
+        d.indexes[(d.count - 1) / 3] = last;
+}
+
+// 拟合 pts[first..last]，误差超出时在误差最大点处分为两段递归拟合
+static void fitCubic(FitBeziersData& d, Int32 first, Int32 last,
+                     const Vector2d& tan1, const Vector2d& tan2)
+{
+    Point2d bz[4];
+    Int32 split;
+    
+    if (last - first < 2) {                     // 两点间按弦长的1/3取控制点
+        float dist = d.pts[first].distanceTo(d.pts[last]) / 3;
+        bz[0] = d.pts[first];
+        bz[1] = bz[0] + tan1 * dist;
+        bz[3] = d.pts[last];
+        bz[2] = bz[3] + tan2 * dist;
+        addBezier(d, last, bz);
+        return;
+    }
+    
+    chordLengthParams(d.pts, first, last, d.u);
+    generateBezier(d, first, last, tan1, tan2, bz);
+    
+    float err = computeMaxError(d, first, last, bz, split);
+    
+    for (int i = 0; i < 4 && err >= d.tol && err < d.tol * 4; i++) {
+        reparameterize(d, first, last, bz);     // 误差不太大时先修正参数再拟合
+        generateBezier(d, first, last, tan1, tan2, bz);
+        err = computeMaxError(d, first, last, bz, split);
+    }
+    if (err < d.tol) {
+        addBezier(d, last, bz);
+        return;
+    }
+    
+    Vector2d center(d.pts[split - 1] - d.pts[split + 1]);   // 分段点的切向
+    
+    if (!center.normalize()) {
+        center = (d.pts[split - 1] - d.pts[split]).unitVector();
+    }
+    fitCubic(d, first, split, tan1, center);
+    fitCubic(d, split, last, -center, tan2);
+}
+
+GEOMAPI Int32 mgFitBeziers(
+    Int32 n, const Point2d* pts, float tol, Point2d* out, Int32* indexes)
+{
+    if (n < 2 || pts == NULL || out == NULL)
+        return 0;
+    
+    FitBeziersData d = { pts, new float[n], tol, out, indexes, 0 };
+    Vector2d tan1(pts[1] - pts[0]);
+    Vector2d tan2(pts[n - 2] - pts[n - 1]);
+    
+    tan1.normalize();
+    tan2.normalize();
+    if (indexes)
+        indexes[0] = 0;
+    fitCubic(d, 0, n - 1, tan1, tan2);
+    delete[] d.u;
+    
+    return d.count;
+}
+
+// 计算椭圆弧的等角度分段数，使弦高不超过容差
+static Int32 arcSegments(float rx, float ry, float sweepAngle, float tol)
+{
+    float r = mgMax(rx, ry);
+    float step = tol < r ? 2.f * acosf(1.f - tol / r) : _M_PI_2;
+    float n = fabsf(sweepAngle) / mgMax(step, 1e-4f);
+    
+    return n < 1.f ? 1 : (n > 4095.f ? 4096 : (Int32)ceilf(n));
+}
+
+GEOMAPI Int32 mgAngleArcToLines(
+    Point2d* pxs, Int32 maxCount, const Point2d& center, float rx, float ry,
+    float startAngle, float sweepAngle, float tol)
+{
+    if (mgIsZero(rx) || fabs(sweepAngle) < 1e-5)
+        return 0;
+    if (mgIsZero(ry))
+        ry = rx;
+    if (sweepAngle > _M_2PI)
+        sweepAngle = _M_2PI;
+    else if (sweepAngle < -_M_2PI)
+        sweepAngle = -_M_2PI;
+    
+    Int32 n = arcSegments(rx, ry, sweepAngle, tol);
+    
+    if (pxs != NULL)
+    {
+        for (Int32 i = 0; i <= n && i < maxCount; i++)
+        {
+            float angle = startAngle + sweepAngle * i / n;
+            pxs[i].set(center.x + rx * cosf(angle), center.y + ry * sinf(angle));
+        }
+    }
+    
+    return n + 1;
+}
+
+GEOMAPI Int32 mgEllipseToLines(
+    Point2d* pxs, Int32 maxCount, const Point2d& center, 
+    float rx, float ry, float tol)
+{
+    if (mgIsZero(rx))
+        return 0;
+    if (mgIsZero(ry))
+        ry = rx;
+    
+    Int32 n = mgMax(arcSegments(rx, ry, _M_2PI, tol), (Int32)4);
+    
+    if (pxs != NULL)
+    {
+        for (Int32 i = 0; i < n && i < maxCount; i++)
+        {
+            float angle = _M_2PI * i / n;
+            pxs[i].set(center.x + rx * cosf(angle), center.y + ry * sinf(angle));
+        }
+    }
+    
+    return n;
+}
+
 static Int32 RemoveSamePoint(Int32 &n, Point2d* knots, float tol)
 {
     for (int i = 0; i < n - 1; i++)
@@ -447,6 +447,47 @@ GEOMAPI MgPtInAreaRet mgPtInArea(
     return 0 == odd ? kMgPtInArea : kMgPtOutArea;
 }
 
+// 功能: 判断一点是否在一多边形范围内，只检查给定的边
+GEOMAPI MgPtInAreaRet mgPtInAreaEdges(
+    const Point2d& pt, Int32 count, const Point2d* vertexs, 
+    Int32 nedges, const Int32* edges, Int32& order, const Tol& tol)
+{
+    Int32 i, j;
+    int odd = 1;
+    
+    // 与P重合的顶点在竖直窄条内，其前后两边都在给定的边中，取最小顶点号
+    order = -1;
+    for (j = 0; j < nedges; j++)
+    {
+        i = edges[j];
+        if (pt.isEqualTo(vertexs[i], tol) && (order < 0 || i < order))
+            order = i;
+        i = (i+1 < count) ? i+1 : 0;
+        if (pt.isEqualTo(vertexs[i], tol) && (order < 0 || i < order))
+            order = i;
+    }
+    if (order >= 0)
+        return kMgPtAtVertex;
+    
+    // 其余边在X方向上不包含P，既不经过P，也不与竖直射线相交
+    for (j = 0; j < nedges; j++)
+    {
+        i = edges[j];
+        const Point2d& p1 = vertexs[i];
+        const Point2d& p2 = (i+1 < count) ? vertexs[i+1] : vertexs[0];
+        
+        if (mgIsBetweenLine2(p1, p2, pt, tol))
+        {
+            order = i;
+            return kMgPtOnEdge;
+        }
+        
+        PtInArea_Edge(odd, pt, p1, p2, i > 0 ? vertexs[i-1] : vertexs[count-1]);
+    }
+    
+    return 0 == odd ? kMgPtInArea : kMgPtOutArea;
+}
+
 // 判断多边形是否为凸多边形
 GEOMAPI bool mgIsConvex(Int32 count, const Point2d* vs, bool* pACW)
 {
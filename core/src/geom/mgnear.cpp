@@ -88,26 +88,27 @@ GEOMAPI float mgCubicSplinesHit(
     Int32 n, const Point2d* knots, const Vector2d* knotvs, bool closed, 
     const Point2d& pt, float tol, Point2d& nearpt, Int32& segment)
 {
+    const Int32 BATCH = 16;
     Point2d ptTemp;
     float dDist, dDistMin = _FLT_MAX;
-    Point2d pts[4];
-    const Box2d rect (pt, 2 * tol, 2 * tol);
+    Point2d pts[4 * BATCH];
     Int32 n2 = (closed && n > 1) ? n + 1 : n;
+    Int32 i, m, seg;
 
     segment = -1;
-    for (Int32 i = 0; i + 1 < n2; i++)
+    for (i = 0, m = 0; i + 1 < n2; i++)
     {
-        mgCubicSplineToBezier(n, knots, knotvs, i, pts);
-        if (rect.isIntersect(computeCubicBox(pts)))
+        mgCubicSplineToBezier(n, knots, knotvs, i, pts + 4 * m);
+        if (++m == BATCH || i + 2 == n2)    // 每批计算多段，已有的最近距离用于跳过远处的段
         {
-            mgNearestOnBezier(pt, pts, ptTemp);
-            dDist = pt.distanceTo(ptTemp);
-            if (dDist <= tol && dDist < dDistMin)
+            dDist = mgNearestOnBeziers(pt, m, pts, 4, mgMin(tol, dDistMin), ptTemp, seg);
+            if (seg >= 0 && dDist < dDistMin)
             {
                 dDistMin = dDist;
                 nearpt = ptTemp;
-                segment = i;
+                segment = i + 1 - m + seg;
             }
+            m = 0;
         }
     }
 
@@ -1,7 +1,8 @@
-// mgnearbz.cpp: 实现贝塞尔曲线段最近点计算函数 mgNearestOnBezier
+// mgnearbz.cpp: 实现贝塞尔曲线段最近点计算函数 mgNearestOnBezier, mgNearestOnBeziers
 // Copyright (c) 2004-2012, Zhang Yungui
 // License: LGPL, https://github.com/rhcad/touchvg
 
+#include "mgnear.h"
 #include "mgcurv.h"
 
 static const int DEGREE     = 3;    // Cubic Bezier curve
@@ -390,3 +391,150 @@ GEOMAPI void mgNearestOnBezier(
     // printf("t : %4.12f\n", t);
     nearpt = (BezierPoint(pts, DEGREE, t, (Point2d *)NULL, (Point2d *)NULL));
 }
+
+// 点到控制点绑定框的距离平方，曲线段在控制点的凸包内，因此是到曲线段距离平方的下界
+static inline float boxDistSqrd(const Point2d& pt, const Point2d* p)
+{
+    float xmin = mgMin(mgMin(p[0].x, p[1].x), mgMin(p[2].x, p[3].x));
+    float xmax = mgMax(mgMax(p[0].x, p[1].x), mgMax(p[2].x, p[3].x));
+    float ymin = mgMin(mgMin(p[0].y, p[1].y), mgMin(p[2].y, p[3].y));
+    float ymax = mgMax(mgMax(p[0].y, p[1].y), mgMax(p[2].y, p[3].y));
+    float dx = mgMax(mgMax(xmin - pt.x, pt.x - xmax), 0.f);
+    float dy = mgMax(mgMax(ymin - pt.y, pt.y - ymax), 0.f);
+    
+    return dx * dx + dy * dy;
+}
+
+static const int NSAMPLES = 16;     // 每段曲线的采样间隔数
+
+// 等参数采样找出各局部最近的采样点，再用牛顿迭代求精确参数，返回距离平方
+static float nearestByNewton(const Point2d& pt, const Point2d* p, float& t)
+{
+    // 幂基形式 B(t) - pt = ((a*t + b)*t + c)*t + d
+    const float ax = p[3].x - p[0].x + 3 * (p[1].x - p[2].x);
+    const float ay = p[3].y - p[0].y + 3 * (p[1].y - p[2].y);
+    const float bx = 3 * (p[0].x - 2 * p[1].x + p[2].x);
+    const float by = 3 * (p[0].y - 2 * p[1].y + p[2].y);
+    const float cx = 3 * (p[1].x - p[0].x);
+    const float cy = 3 * (p[1].y - p[0].y);
+    const float dx = p[0].x - pt.x;
+    const float dy = p[0].y - pt.y;
+    float ds[NSAMPLES + 1];
+    int i, k;
+    
+    for (i = 0; i <= NSAMPLES; i++) {           // 没有分支，编译器可向量化
+        float s = (float)i / NSAMPLES;
+        float x = ((ax * s + bx) * s + cx) * s + dx;
+        float y = ((ay * s + by) * s + cy) * s + dy;
+        ds[i] = x * x + y * y;
+    }
+    
+    float best = _FLT_MAX;
+    
+    t = 0;
+    for (i = 0; i <= NSAMPLES; i++) {           // 端点附近也可能有更近的点
+        if ((i > 0 && ds[i] > ds[i - 1]) || (i < NSAMPLES && ds[i] > ds[i + 1]))
+            continue;
+        
+        float lo = (float)mgMax(i - 1, 0) / NSAMPLES;
+        float hi = (float)mgMin(i + 1, NSAMPLES) / NSAMPLES;
+        float s = (float)i / NSAMPLES;
+        float dist = ds[i];
+        
+        for (k = 0; k < 16; k++) {               // 求 f(s) = (B(s)-pt)·B'(s) = 0 的根
+            float x = ((ax * s + bx) * s + cx) * s + dx;
+            float y = ((ay * s + by) * s + cy) * s + dy;
+            float x1 = (3 * ax * s + 2 * bx) * s + cx;
+            float y1 = (3 * ay * s + 2 * by) * s + cy;
+            float x2 = 6 * ax * s + 2 * bx;
+            float y2 = 6 * ay * s + 2 * by;
+            float f = x * x1 + y * y1;
+            float df = x1 * x1 + y1 * y1 + x * x2 + y * y2;
+            float next = df > 1e-12f ? s - f / df : -1.f;
+            
+            if (f > 0)                          // 距离在增大，最近点在左侧
+                hi = s;
+            else
+                lo = s;
+            if (next > lo && next < hi) {
+                if (fabsf(next - s) < 1e-6f)    // 已收敛
+                    break;
+                s = next;
+            }
+            else {
+                s = (lo + hi) / 2;              // 牛顿步出界时二分
+            }
+        }
+        
+        float x = ((ax * s + bx) * s + cx) * s + dx;
+        float y = ((ay * s + by) * s + cy) * s + dy;
+        
+        if (x * x + y * y < dist) {             // 迭代不收敛时仍用采样点
+            dist = x * x + y * y;
+        }
+        else {
+            s = (float)i / NSAMPLES;
+        }
+        if (dist < best) {
+            best = dist;
+            t = s;
+        }
+    }
+    
+    return best;
+}
+
+GEOMAPI float mgNearestOnBeziers(
+    const Point2d& pt, Int32 n, const Point2d* pts, Int32 stride,
+    float tol, Point2d& nearpt, Int32& segment, float* tout)
+{
+    float bestSq = tol * tol;
+    float bestT = 0;
+    float t, dist;
+    Int32 i;
+    
+    segment = -1;
+    
+    // 用各段端点的距离得到初始的最近距离
+    for (i = 0; i < n; i++) {
+        const Point2d* p = pts + i * stride;
+        
+        dist = (p[0] - pt).lengthSqrd();
+        if (dist < bestSq || (segment < 0 && dist <= bestSq)) {
+            bestSq = dist;
+            bestT = 0;
+            segment = i;
+        }
+        dist = (p[3] - pt).lengthSqrd();
+        if (dist < bestSq || (segment < 0 && dist <= bestSq)) {
+            bestSq = dist;
+            bestT = 1;
+            segment = i;
+        }
+    }
+    
+    // 控制点绑定框的距离下界不小于当前最近距离的段不必计算
+    for (i = 0; i < n; i++) {
+        const Point2d* p = pts + i * stride;
+        float lower = boxDistSqrd(pt, p);
+        
+        if (segment >= 0 ? lower >= bestSq : lower > bestSq)
+            continue;
+        
+        dist = nearestByNewton(pt, p, t);
+        if (dist < bestSq || (segment < 0 && dist <= bestSq)) {
+            bestSq = dist;
+            bestT = t;
+            segment = i;
+        }
+    }
+    
+    if (segment < 0)
+        return _FLT_MAX;
+    
+    mgFitBezier(pts + segment * stride, bestT, nearpt);
+    if (tout)
+        *tout = bestT;
+    
+    return nearpt.distanceTo(pt);
+}
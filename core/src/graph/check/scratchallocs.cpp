@@ -0,0 +1,148 @@
+// scratchallocs.cpp: 检查 GiGraphics 绘图稳定后不再分配堆内存
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+//
+// 由 src/graph/Makefile 的 check 目标编译运行，重复显示同一组部分可见的折线、
+// 多边形、曲线和样条，前几帧扩充缓冲区后，以后各帧的 GiDrawStats::scratchAllocs
+// 和全局 operator new 的调用次数都应为0，否则返回非0。
+
+#include <gicanvas.h>
+#include <gigraph.h>
+#include <gicontxt.h>
+#include <mgcurv.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static long s_news = 0;         // 全局 operator new 的调用次数
+
+void* operator new(size_t size)
+{
+    void* p = malloc(size ? size : 1);
+
+    s_news++;
+    if (!p)
+        abort();
+    return p;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* p)
+{
+    free(p);
+}
+
+void operator delete[](void* p)
+{
+    free(p);
+}
+
+//! 只统计图元个数的画布，本身不分配内存
+class CountingCanvas : public GiCanvas
+{
+public:
+    GiContext   ctx;
+    long        prims;
+
+    CountingCanvas() : prims(0) {}
+
+    virtual void clearWindow() {}
+    virtual bool drawCachedBitmap(float, float, bool) { return false; }
+    virtual bool drawCachedBitmap2(const GiCanvas*, float, float, bool) { return false; }
+    virtual void saveCachedBitmap(bool) {}
+    virtual bool hasCachedBitmap(bool) const { return false; }
+    virtual bool isBufferedDrawing() const { return false; }
+    virtual int getCanvasType() const { return 0; }
+    virtual const GiContext* getCurrentContext() const { return &ctx; }
+    virtual void _clipBoxChanged(const RECT_2D&) {}
+    virtual void _antiAliasModeChanged(bool) {}
+    virtual void clearCachedBitmap(bool) {}
+    virtual float getScreenDpi() const { return 96; }
+    virtual GiColor getBkColor() const { return GiColor::White(); }
+    virtual GiColor setBkColor(const GiColor& color) { return color; }
+    virtual bool rawLine(const GiContext*, float, float, float, float) { return ++prims > 0; }
+    virtual bool rawLines(const GiContext*, const Point2d*, int) { return ++prims > 0; }
+    virtual bool rawBeziers(const GiContext*, const Point2d*, int) { return ++prims > 0; }
+    virtual bool rawPolygon(const GiContext*, const Point2d*, int) { return ++prims > 0; }
+    virtual bool rawRect(const GiContext*, float, float, float, float) { return ++prims > 0; }
+    virtual bool rawEllipse(const GiContext*, float, float, float, float) { return ++prims > 0; }
+    virtual bool rawBeginPath() { return true; }
+    virtual bool rawEndPath(const GiContext*, bool) { return ++prims > 0; }
+    virtual bool rawMoveTo(float, float) { return true; }
+    virtual bool rawLineTo(float, float) { return true; }
+    virtual bool rawBezierTo(float, float, float, float, float, float) { return true; }
+    virtual bool rawClosePath() { return true; }
+};
+
+enum { kShapes = 500, kMaxPoints = 64, kFrames = 8, kWarmFrames = 3 };
+
+static Point2d  s_points[kShapes][kMaxPoints];
+static Vector2d s_knotvs[kShapes][kMaxPoints];
+static int      s_counts[kShapes];
+
+static void makeShapes()
+{
+    srand(1);
+    for (int k = 0; k < kShapes; k++) {
+        int n = 4 + rand() % (kMaxPoints - 4);
+
+        s_counts[k] = n;
+        for (int i = 0; i < n; i++) {           // 显示区域为0到100，多数图形部分可见
+            s_points[k][i].set((float)(rand() % 300 - 100), (float)(rand() % 300 - 100));
+        }
+        mgCubicSplines(n, s_points[k], s_knotvs[k]);
+    }
+}
+
+static void drawFrame(GiGraphics& gs, const GiContext& ctx, const GiContext& fillctx)
+{
+    for (int k = 0; k < kShapes; k++) {
+        const Point2d* pts = s_points[k];
+        int n = s_counts[k];
+        int nbz = 1 + (n - 1) / 3 * 3;
+
+        gs.drawLines(&ctx, n, pts);
+        gs.drawPolygon(&fillctx, n, pts);
+        gs.drawBeziers(&ctx, nbz, pts);
+        gs.drawBeziers(&fillctx, nbz, pts, true);
+        gs.drawSplines(&ctx, n, pts, s_knotvs[k]);
+        gs.drawBSplines(&ctx, n, pts);
+        gs.drawClosedBSplines(&fillctx, n, pts);
+    }
+}
+
+int main()
+{
+    GiTransform xf;
+    GiGraphics gs(&xf);
+    CountingCanvas canvas;
+    GiContext ctx(0, GiColor::Black());
+    GiContext fillctx(0, GiColor::Black(), kGiLineSolid, GiColor(0, 0, 255, 128));
+    RECT_2D rc = { 0, 0, 800, 600 };
+    int failed = 0;
+
+    xf.setWndSize(800, 600);
+    xf.zoomTo(Box2d(0.f, 0.f, 100.f, 100.f));
+    gs._setCanvas(&canvas);
+    makeShapes();
+
+    for (int frame = 0; frame < kFrames; frame++) {
+        long news = s_news;
+
+        gs._beginPaint(rc);
+        drawFrame(gs, ctx, fillctx);
+        gs._endPaint();
+
+        news = s_news - news;
+        printf("frame %d: scratchAllocs %ld, operator new %ld, primitives %ld\n",
+               frame, gs.stats().scratchAllocs, news, canvas.prims);
+        if (frame >= kWarmFrames && (gs.stats().scratchAllocs != 0 || news != 0))
+            failed++;
+    }
+
+    printf(failed ? "FAILED: heap allocations in steady state\n" : "OK\n");
+    return failed ? 1 : 0;
+}
@@ -7,6 +7,15 @@
 #include <mglnrel.h>
 #include <mgcurv.h>
 #include "giplclip.h"
+#include "gitiles.h"
+
+#if defined(_WIN32)
+#elif defined(_MACOSX)
+#include <mach/mach_time.h>
+#else
+#include <time.h>
+#include <sys/time.h>
+#endif
 
 #ifndef SafeCall
 #define SafeCall(p, f)      if (p) p->f
@@ -33,8 +42,15 @@ void GiGraphics::copy(const GiGraphics& src)
     if (this != &src)
     {
         m_impl->maxPenWidth = src.m_impl->maxPenWidth;
+        m_impl->minPenWidth = src.m_impl->minPenWidth;
         m_impl->antiAlias = src.m_impl->antiAlias;
         m_impl->colorMode = src.m_impl->colorMode;
+        m_impl->lodMode = src.m_impl->lodMode;
+        m_impl->lodThreshold = src.m_impl->lodThreshold;
+        m_impl->lodCellSize = src.m_impl->lodCellSize;
+        m_impl->styleSorting = src.m_impl->styleSorting;
+        m_impl->occlusionCulling = src.m_impl->occlusionCulling;
+        m_impl->incrementalPan = src.m_impl->incrementalPan;
     }
 }
 
@@ -55,6 +71,13 @@ void GiGraphics::_beginPaint(const RECT_2D& clipBox)
         m_impl->zoomChanged();
         m_impl->lastZoomTimes = xf().getZoomTimes();
     }
+    if (m_impl->drawRefcnt == 0)
+    {
+        m_impl->stats.reset();
+        m_impl->allocBase = m_impl->allocCount();
+        m_impl->paintStart = GiDrawStats::tickMs();
+        m_impl->scratch.reset();
+    }
     giInterlockedIncrement(&m_impl->drawRefcnt);
 
     if (!Box2d(clipBox).isEmpty())
@@ -63,6 +86,8 @@ void GiGraphics::_beginPaint(const RECT_2D& clipBox)
         m_impl->clipBox  = clipBox;
         m_impl->rectDraw = Box2d(clipBox);
         m_impl->rectDraw.inflate(GiGraphicsImpl::CLIP_INFLATE);
+        m_impl->rectClip.set(0, 0, (float)xf().getWidth(), (float)xf().getHeight());
+        m_impl->rectClip.inflate(GiGraphicsImpl::CLIP_INFLATE);
         m_impl->rectDrawM = Box2d(m_impl->rectDraw) * xf().displayToModel();
         m_impl->rectDrawMaxM = Box2d(0, 0, xf().getWidth(), xf().getHeight()) * xf().displayToModel();
         m_impl->rectDrawW = m_impl->rectDrawM * xf().modelToWorld();
@@ -72,7 +97,11 @@ void GiGraphics::_beginPaint(const RECT_2D& clipBox)
 
 void GiGraphics::_endPaint()
 {
-    giInterlockedDecrement(&m_impl->drawRefcnt);
+    if (giInterlockedDecrement(&m_impl->drawRefcnt) == 0)
+    {
+        m_impl->stats.scratchAllocs = m_impl->allocCount() - m_impl->allocBase;
+        m_impl->stats.paintMs = (float)(GiDrawStats::tickMs() - m_impl->paintStart);
+    }
 }
 
 bool GiGraphics::isDrawing() const
@@ -182,6 +211,147 @@ void GiGraphics::setColorMode(GiColorMode mode)
     m_impl->colorMode = mode;
 }
 
+GiLodMode GiGraphics::getLodMode() const
+{
+    return m_impl->lodMode;
+}
+
+float GiGraphics::getLodThreshold() const
+{
+    return m_impl->lodThreshold;
+}
+
+float GiGraphics::getLodCellSize() const
+{
+    return m_impl->lodCellSize;
+}
+
+void GiGraphics::setLodMode(GiLodMode mode, float pixels, float cellPixels)
+{
+    m_impl->lodMode = mode;
+    if (pixels >= 0)
+        m_impl->lodThreshold = pixels;
+    if (cellPixels >= 1)
+        m_impl->lodCellSize = cellPixels;
+}
+
+bool GiGraphics::isStyleSorting() const
+{
+    return m_impl->styleSorting;
+}
+
+void GiGraphics::setStyleSorting(bool sorting)
+{
+    m_impl->styleSorting = sorting;
+}
+
+bool GiGraphics::isOcclusionCulling() const
+{
+    return m_impl->occlusionCulling;
+}
+
+void GiGraphics::setOcclusionCulling(bool enabled)
+{
+    m_impl->occlusionCulling = enabled;
+}
+
+bool GiGraphics::isIncrementalPan() const
+{
+    return m_impl->incrementalPan;
+}
+
+void GiGraphics::setIncrementalPan(bool enabled)
+{
+    m_impl->incrementalPan = enabled;
+    m_impl->panned = false;
+    m_impl->panX = m_impl->panY = 0;
+}
+
+bool GiGraphics::drawCachedBitmap(GiTileDrawer* drawer)
+{
+    GiCanvas* canvas = m_impl->canvas;
+    if (!canvas || !isDrawing() || !canvas->hasCachedBitmap())
+    {
+        m_impl->panned = false;
+        m_impl->panX = m_impl->panY = 0;
+        return false;
+    }
+    if (!m_impl->panned || !drawer)
+        return canvas->drawCachedBitmap();
+
+    const int dx = m_impl->panX;
+    const int dy = m_impl->panY;
+    const float w = (float)xf().getWidth();
+    const float h = (float)xf().getHeight();
+    RECT_2D rcs[2];
+    int n = 0;
+
+    m_impl->panned = false;
+    m_impl->panX = m_impl->panY = 0;
+    if (!canvas->drawCachedBitmap((float)dx, (float)dy))
+        return false;
+
+    // 露出的区域: 左右一条竖条和上下一条横条，横条不含竖条部分以免重复显示
+    if (dx != 0)
+    {
+        RECT_2D& rc = rcs[n++];
+        rc.left = dx > 0 ? 0 : w + dx;
+        rc.right = dx > 0 ? (float)dx : w;
+        rc.top = 0;
+        rc.bottom = h;
+    }
+    if (dy != 0)
+    {
+        RECT_2D& rc = rcs[n++];
+        rc.left = dx > 0 ? (float)dx : 0;
+        rc.right = dx < 0 ? w + dx : w;
+        rc.top = dy > 0 ? 0 : h + dy;
+        rc.bottom = dy > 0 ? (float)dy : h;
+    }
+    for (int i = 0; i < n; i++)
+    {
+        GiSaveClipBox clip(this, Box2d(rcs[i]) * xf().displayToWorld());
+        if (clip.succeed())
+        {
+            drawer->drawTile(*this);
+            m_impl->stats.panStrips++;
+        }
+    }
+    canvas->saveCachedBitmap();
+
+    return true;
+}
+
+GiDrawStats& GiGraphics::stats()
+{
+    return m_impl->stats;
+}
+
+double GiDrawStats::tickMs()
+{
+#if defined(_WIN32)
+    static LARGE_INTEGER freq = { 0 };
+    LARGE_INTEGER now;
+    if (freq.QuadPart == 0)
+        QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart * 1000.0 / (double)freq.QuadPart;
+#elif defined(_MACOSX)
+    static mach_timebase_info_data_t info = { 0, 0 };
+    if (info.denom == 0)
+        mach_timebase_info(&info);
+    return (double)mach_absolute_time() * info.numer / info.denom * 1e-6;
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec * 1e-6;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000.0 + tv.tv_usec * 1e-3;
+#endif
+}
+
 GiColor GiGraphics::calcPenColor(const GiColor& color) const
 {
     GiColor ret = color;
@@ -277,8 +447,12 @@ bool GiGraphics::drawLine(const GiContext* ctx,
 
     Point2d pts[2] = { startPt * S2D(xf(), modelUnit), endPt * S2D(xf(), modelUnit) };
 
-    if (!mgClipLine(pts[0], pts[1], m_impl->rectDraw))
-        return false;
+    if (!m_impl->rectClip.contains(pts[0]) || !m_impl->rectClip.contains(pts[1]))
+    {
+        m_impl->stats.clipOps++;
+        if (!mgClipLine(pts[0], pts[1], m_impl->rectClip))
+            return false;
+    }
 
     return rawLine(ctx, pts[0].x, pts[0].y, pts[1].x, pts[1].y);
 }
@@ -300,7 +474,8 @@ public:
 };
 
 static bool DrawEdge(int count, int &i, Point2d* pts, Point2d &ptLast, 
-                     const PolylineAux& aux, const Box2d& rectDraw)
+                     const PolylineAux& aux, const Box2d& rectDraw,
+                     GiPointArena& scratch)
 {
     int n, si, ei;
     Point2d pt1, pt2;
@@ -341,9 +516,8 @@ static bool DrawEdge(int count, int &i, Point2d* pts, Point2d &ptLast,
     n = ei - si + 1;
     if (n > 1)
     {
-        vector<Point2d> pxpoints;
-        pxpoints.resize(n);
-        Point2d* pxs = &pxpoints.front();
+        GiScratchPoints pxpoints(scratch, n);
+        Point2d* pxs = pxpoints.points();
         n = 0;
         for (int j = si; j <= ei; j++)
         {
@@ -373,8 +547,6 @@ bool GiGraphics::drawLines(const GiContext* ctx, int count,
 
     int i;
     Point2d pt1, pt2, ptLast;
-    vector<Point2d> pxpoints;
-    vector<Point2d> pointBuf;
     bool ret = false;
     Matrix2d matD(S2D(xf(), modelUnit));
 
@@ -382,10 +554,12 @@ bool GiGraphics::drawLines(const GiContext* ctx, int count,
     if (!DRAW_RECT(m_impl, modelUnit).isIntersect(extent))  // 全部在显示区域外
         return false;
 
+    GiScratchPoints pointBuf(m_impl->scratch, count);
+    Point2d* pts = pointBuf.points();
+
     if (DRAW_MAXR(m_impl, modelUnit).contains(extent))  // 全部在显示区域内
     {
-        pxpoints.resize(count);
-        Point2d* pxs = &pxpoints.front();
+        Point2d* pxs = pts;
         int n = 0;
         for (i = 0; i < count; i++)
         {
@@ -400,22 +574,102 @@ bool GiGraphics::drawLines(const GiContext* ctx, int count,
     }
     else                                            // 部分在显示区域内
     {
-        pointBuf.resize(count);
         for (i = 0; i < count; i++)                 // 转换到像素坐标
-            pointBuf[i] = points[i] * matD;
-        Point2d* pts = &pointBuf.front();
+            pts[i] = points[i] * matD;
 
+        m_impl->stats.clipOps++;
         ptLast = pts[0];
         PolylineAux aux(this, ctx);
         for (i = 0; i < count - 1; i++)
         {
-            ret = DrawEdge(count, i, pts, ptLast, aux, m_impl->rectDraw) || ret;
+            ret = DrawEdge(count, i, pts, ptLast, aux, 
+                m_impl->rectClip, m_impl->scratch) || ret;
         }
     }
 
     return ret;
 }
 
+static bool rawBezierPath(GiGraphics* gs, const GiContext* ctx, int count, 
+                          const Point2d* pxs, const char* types)
+{
+    bool ret = gs->rawBeginPath();
+    if (ret)
+    {
+        ret = gs->rawMoveTo(pxs[0].x, pxs[0].y);
+        for (int i = 1; i < count; i++) {
+            if (types && types[i] == kGiLineTo) {
+                ret = gs->rawLineTo(pxs[i].x, pxs[i].y);
+            }
+            else if (i + 2 < count) {
+                ret = gs->rawBezierTo(pxs[i].x, pxs[i].y,
+                    pxs[i+1].x, pxs[i+1].y, pxs[i+2].x, pxs[i+2].y);
+                i += 2;
+            }
+        }
+        ret = gs->rawClosePath();
+        ret = gs->rawEndPath(ctx, true);
+    }
+    return ret;
+}
+
+// 显示像素坐标的多段贝塞尔曲线，部分在显示区域外时细分剪裁
+static bool drawBeziersD(GiGraphics* gs, GiGraphicsImpl* impl, const GiContext* ctx, 
+                         int count, const Point2d* pxs, bool closed)
+{
+    if (impl->rectClip.contains(Box2d(count, pxs)))    // 全部在显示区域内
+    {
+        return closed ? rawBezierPath(gs, ctx, count, pxs, NULL)
+            : gs->rawBeziers(ctx, pxs, count);
+    }
+
+    impl->stats.clipOps++;
+    BezierClip clip (impl->rectClip, impl->clipBuf1, impl->clipTypes, closed);
+    bool clipped = clip.clip(count, pxs);
+    impl->checkBufferGrowth();
+    if (!clipped)
+        return false;
+
+    const Point2d* pts = clip.getPoints();
+    const char* types = clip.getTypes();
+    const int n = clip.getCount();
+    GiContext context;
+    bool ret = false;
+
+    if (closed && !clip.hasOutside())
+        return rawBezierPath(gs, ctx, n, pts, types);
+    if (closed)                         // 填充剪裁后的区域，只显示可见的边
+    {
+        if (!ctx)
+            ctx = impl->canvas->getCurrentContext();
+        if (!ctx)
+            return false;
+
+        context = *ctx;
+        context.setNullLine();
+        if (context.hasFillColor())
+            ret = rawBezierPath(gs, &context, n, pts, types);
+
+        context = *ctx;
+        context.setNoFillColor();
+        ctx = &context;
+        if (context.isNullLine() || !clip.hasBeziers())
+            return ret;                 // 包住显示区域时边线都不可见
+    }
+
+    for (int i = 0; i < n; )            // 可见的各段连续曲线
+    {
+        int j = i + 1;
+        while (j < n && types[j] == kGiBeziersTo)
+            j++;
+        if (j - i > 1)
+            ret = gs->rawBeziers(ctx, pts + i, j - i) || ret;
+        i = j;
+    }
+
+    return ret;
+}
+
 bool GiGraphics::drawBeziers(const GiContext* ctx, int count, 
                              const Point2d* points, bool closed, bool modelUnit)
 {
@@ -426,68 +680,19 @@ bool GiGraphics::drawBeziers(const GiContext* ctx, int count,
         count = 0x2000;
     count = 1 + (count - 1) / 3 * 3;
 
-    bool ret = false;
-    vector<Point2d> pxpoints;
-    vector<Point2d> pointBuf;
-    int i, j, n, si, ei;
-    Point2d * pxs;
     Matrix2d matD(S2D(xf(), modelUnit));
 
     const Box2d extent (count, points);                 // 模型坐标范围
     if (!DRAW_RECT(m_impl, modelUnit).isIntersect(extent))  // 全部在显示区域外
         return false;
     
-    if (closed) {
-        pxpoints.resize(count);
-        pxs = &pxpoints.front();
-        for (i = 0; i < count; i++)
-            pxs[i] = points[i] * matD;
-        ret = rawBeginPath();
-        if (ret)
-        {
-            ret = rawMoveTo(pxs[0].x, pxs[0].y);
-            for (i = 1; i + 2 < getSize(pxpoints); i += 3) {
-                ret = rawBezierTo(pxs[i].x, pxs[i].y,
-                    pxs[i+1].x, pxs[i+1].y, pxs[i+2].x, pxs[i+2].y);
-            }
-            ret = rawClosePath();
-            ret = rawEndPath(ctx, true);
-        }
-    }
-    else if (DRAW_MAXR(m_impl, modelUnit).contains(extent))  // 全部在显示区域内
-    {
-        pxpoints.resize(count);
-        pxs = &pxpoints.front();
-        for (i = 0; i < count; i++)
-            pxs[i] = points[i] * matD;
-        ret = rawBeziers(ctx, pxs, count);
-    }
-    else
-    {        
-        pointBuf.resize(count);
-        for (i = 0; i < count; i++)                 // 转换到像素坐标
-            pointBuf[i] = points[i] * matD;
-        Point2d* pts = &pointBuf.front();
+    GiScratchPoints pointBuf(m_impl->scratch, count);
+    Point2d* pxs = pointBuf.points();
 
-        si = ei = 0;
-        for (i = 3; i < count; i += 3)
-        {
-            for ( ; i < count
-                && m_impl->rectDraw.isIntersect(Box2d(4, &pts[ei])); i += 3)
-                ei = i;
-            n = ei - si + 1;
-            if (n > 1)
-            {
-                pxpoints.resize(n);
-                pxs = &pxpoints.front();
-                for (j=0; j<n; j++)
-                    pxs[j] = pts[si + j];
-                ret = rawBeziers(ctx, pxs, n);
-            }
-            si = ei = i;
-        }
-    }
-    return ret;
+    for (int i = 0; i < count; i++)                 // 转换到像素坐标
+        pxs[i] = points[i] * matD;
+
+    return drawBeziersD(this, m_impl, ctx, count, pxs, closed);
 }
 
 bool GiGraphics::drawArc(const GiContext* ctx, 
@@ -510,7 +715,7 @@ bool GiGraphics::drawArc(const GiContext* ctx,
         rx, ry, startAngle, sweepAngle);
     S2D(xf(), modelUnit).TransformPoints(count, points);
 
-    return count > 3 && rawBeziers(ctx, points, count);
+    return count > 3 && drawBeziersD(this, m_impl, ctx, count, points, false);
 }
 
 static inline int findInvisibleEdge(const PolygonClip& clip)
@@ -534,10 +739,9 @@ static inline int findInvisibleEdge(const PolygonClip& clip, int i, int end)
 
 static bool drawPolygonEdge(const PolylineAux& aux, 
                             int count, const PolygonClip& clip, 
-                            int ienter)
+                            int ienter, GiPointArena& scratch)
 {
     bool ret = false;
-    vector<Point2d> pxpoints;
     Point2d pt1, pt2;
     int si, ei, n, i;
 
@@ -548,8 +752,8 @@ static bool drawPolygonEdge(const PolylineAux& aux,
         n = ei - si + 1;
         if (n > 1)
         {
-            pxpoints.resize(n);
-            Point2d *pxs = &pxpoints.front();
+            GiScratchPoints pxpoints(scratch, n);
+            Point2d *pxs = pxpoints.points();
             n = 0;
             for (i = si; i <= ei; i++)
             {
@@ -569,7 +773,8 @@ static bool drawPolygonEdge(const PolylineAux& aux,
     return ret;
 }
 
-static bool _DrawPolygon(GiCanvas* cv, const GiContext* ctx, 
+static bool _DrawPolygon(GiCanvas* cv, GiPointArena& scratch, 
+                         const GiContext* ctx, 
                          int count, const Point2d* points, 
                          bool bM2D, bool bFill, bool bEdge, bool modelUnit)
 {
@@ -587,12 +792,11 @@ static bool _DrawPolygon(GiCanvas* cv, const GiContext* ctx,
     if (context.isNullLine() && !context.hasFillColor())
         return false;
 
-    vector<Point2d> pxpoints;
     Point2d pt1, pt2;
     Matrix2d matD(S2D(cv->gs()->xf(), modelUnit));
 
-    pxpoints.resize(count);
-    Point2d *pxs = &pxpoints.front();
+    GiScratchPoints pxpoints(scratch, count);
+    Point2d *pxs = pxpoints.points();
     int n = 0;
     for (int i = 0; i < count; i++)
     {
@@ -634,29 +838,33 @@ bool GiGraphics::drawPolygon(const GiContext* ctx, int count,
 
     if (DRAW_MAXR(m_impl, modelUnit).contains(extent))  // 全部在显示区域内
     {
-        ret = _DrawPolygon(m_impl->canvas, ctx, 
+        ret = _DrawPolygon(m_impl->canvas, m_impl->scratch, ctx, 
             count, points, true, true, true, modelUnit);
     }
     else                                                // 部分在显示区域内
     {
-        PolygonClip clip (m_impl->rectDraw);
-        if (!clip.clip(count, points, &S2D(xf(), modelUnit)))  // 多边形剪裁
+        m_impl->stats.clipOps++;
+        PolygonClip clip (m_impl->rectClip, m_impl->clipBuf1, m_impl->clipBuf2);
+        bool clipped = clip.clip(count, points, &S2D(xf(), modelUnit));  // 多边形剪裁
+        m_impl->checkBufferGrowth();
+        if (!clipped)
             return false;
         count = clip.getCount();
         points = clip.getPoints();
 
-        ret = _DrawPolygon(m_impl->canvas, ctx, 
+        ret = _DrawPolygon(m_impl->canvas, m_impl->scratch, ctx, 
             count, points, false, true, false, modelUnit);
 
         int ienter = findInvisibleEdge(clip);
         if (ienter == count)
         {
-            ret = _DrawPolygon(m_impl->canvas, ctx, count, points, 
-                false, false, true, modelUnit) || ret;
+            ret = _DrawPolygon(m_impl->canvas, m_impl->scratch, ctx, 
+                count, points, false, false, true, modelUnit) || ret;
         }
         else
         {
-            ret = drawPolygonEdge(PolylineAux(this, ctx), count, clip, ienter) || ret;
+            ret = drawPolygonEdge(PolylineAux(this, ctx), count, clip, 
+                ienter, m_impl->scratch) || ret;
         }
     }
 
@@ -686,7 +894,8 @@ bool GiGraphics::drawEllipse(const GiContext* ctx, const Point2d& center,
     if (!DRAW_RECT(m_impl, modelUnit).isIntersect(extent))  // 全部在显示区域外
         return false;
 
-    if (mgIsZero(matD.m12) && mgIsZero(matD.m21))
+    if (mgIsZero(matD.m12) && mgIsZero(matD.m21)
+        && DRAW_MAXR(m_impl, modelUnit).contains(extent))  // 全部在显示区域内
     {
         Point2d cen (center * matD);
         rx *= (float)fabs(matD.m11);
@@ -700,17 +909,7 @@ bool GiGraphics::drawEllipse(const GiContext* ctx, const Point2d& center,
         mgEllipseToBezier(pxs, center, rx, ry);
         matD.TransformPoints(13, pxs);
 
-        ret = rawBeginPath();
-        if (ret)
-        {
-            ret = rawMoveTo(pxs[0].x, pxs[0].y);
-            for (int i = 1; i + 2 < 13; i += 3) {
-                ret = rawBezierTo(pxs[i].x, pxs[i].y,
-                    pxs[i+1].x, pxs[i+1].y, pxs[i+2].x, pxs[i+2].y);
-            }
-            ret = rawClosePath();
-            ret = rawEndPath(ctx, true);
-        }
+        ret = drawBeziersD(this, m_impl, ctx, 13, pxs, true);
     }
 
     return ret;
@@ -832,12 +1031,12 @@ bool GiGraphics::drawSplines(const GiContext* ctx, int count,
     int i;
     Point2d pt;
     Vector2d vec;
-    vector<Point2d> pxpoints;
     Matrix2d matD(S2D(xf(), modelUnit));
 
     // 开辟像素坐标数组
-    pxpoints.resize(1 + (count - 1) * 3);
-    Point2d *pxs = &pxpoints.front();
+    const int n = 1 + (count - 1) * 3;
+    GiScratchPoints pxpoints(m_impl->scratch, n);
+    Point2d *pxs = pxpoints.points();
 
     pt = knots[0] * matD;                       // 第一个Bezier段的起点
     vec = knotvs[0] * matD / 3.f;               // 第一个Bezier段的起始矢量
@@ -852,7 +1051,7 @@ bool GiGraphics::drawSplines(const GiContext* ctx, int count,
     }
 
     // 绘图
-    return rawBeziers(ctx, &pxpoints.front(), getSize(pxpoints));
+    return drawBeziersD(this, m_impl, ctx, n, pxpoints.points(), false);
 }
 
 bool GiGraphics::drawClosedSplines(const GiContext* ctx, int count, 
@@ -869,12 +1068,12 @@ bool GiGraphics::drawClosedSplines(const GiContext* ctx, int count,
     int i, j = 0;
     Point2d pt;
     Vector2d vec;
-    vector<Point2d> pxpoints;
     Matrix2d matD(S2D(xf(), modelUnit));
 
     // 开辟像素坐标数组
-    pxpoints.resize(1 + count * 3);
-    Point2d *pxs = &pxpoints.front();
+    const int n = 1 + count * 3;
+    GiScratchPoints pxpoints(m_impl->scratch, n);
+    Point2d *pxs = pxpoints.points();
 
     pt = knots[0] * matD;                       // 第一个Bezier段的起点
     vec = knotvs[0] * matD / 3.f;               // 第一个Bezier段的起始矢量
@@ -892,19 +1091,7 @@ bool GiGraphics::drawClosedSplines(const GiContext* ctx, int count,
     pxs[j+1] = pxs[0];                          // 产生Bezier段的终点
 
     // 绘图
-    bool ret = rawBeginPath();
-    if (ret)
-    {
-        ret = rawMoveTo(pxs[0].x, pxs[0].y);
-        for (i = 1; i + 2 < getSize(pxpoints); i += 3) {
-            ret = rawBezierTo(pxs[i].x, pxs[i].y,
-                pxs[i+1].x, pxs[i+1].y, pxs[i+2].x, pxs[i+2].y);
-        }
-        ret = rawClosePath();
-        ret = rawEndPath(ctx, true);
-    }
-
-    return ret;
+    return drawBeziersD(this, m_impl, ctx, n, pxs, true);
 }
 
 bool GiGraphics::drawBSplines(const GiContext* ctx, int count, 
@@ -922,12 +1109,12 @@ bool GiGraphics::drawBSplines(const GiContext* ctx, int count,
     int i;
     Point2d pt1, pt2, pt3, pt4;
     float d6 = 1.f / 6.f;
-    vector<Point2d> pxpoints;
     Matrix2d matD(S2D(xf(), modelUnit));
 
     // 开辟像素坐标数组
-    pxpoints.resize(1 + (count - 3) * 3);
-    Point2d *pxs = &pxpoints.front();
+    const int n = 1 + (count - 3) * 3;
+    GiScratchPoints pxpoints(m_impl->scratch, n);
+    Point2d *pxs = pxpoints.points();
 
     // 计算第一个曲线段
     pt1 = ctlpts[0] * matD;
@@ -952,7 +1139,7 @@ bool GiGraphics::drawBSplines(const GiContext* ctx, int count,
     }
 
     // 绘图
-    return rawBeziers(ctx, &pxpoints.front(), getSize(pxpoints));
+    return drawBeziersD(this, m_impl, ctx, n, pxpoints.points(), false);
 }
 
 bool GiGraphics::drawClosedBSplines(const GiContext* ctx, 
@@ -972,12 +1159,12 @@ bool GiGraphics::drawClosedBSplines(const GiContext* ctx,
     int i;
     Point2d pt1, pt2, pt3, pt4;
     float d6 = 1.f / 6.f;
-    vector<Point2d> pxpoints;
     Matrix2d matD(S2D(xf(), modelUnit));
 
     // 开辟像素坐标数组
-    pxpoints.resize(1 + count * 3);
-    Point2d *pxs = &pxpoints.front();
+    const int n = 1 + count * 3;
+    GiScratchPoints pxpoints(m_impl->scratch, n);
+    Point2d *pxs = pxpoints.points();
 
     // 计算第一个曲线段
     pt1 = ctlpts[0] * matD;
@@ -1002,20 +1189,7 @@ bool GiGraphics::drawClosedBSplines(const GiContext* ctx,
     }
 
     // 绘图
-    bool ret = rawBeginPath();
-    if (ret)
-    {
-        pxs = &pxpoints.front();
-        ret = rawMoveTo(pxs[0].x, pxs[0].y);
-        for (i = 1; i + 2 < getSize(pxpoints); i += 3) {
-            ret = rawBezierTo(pxs[i].x, pxs[i].y,
-                pxs[i+1].x, pxs[i+1].y, pxs[i+2].x, pxs[i+2].y);
-        }
-        ret = rawClosePath();
-        ret = rawEndPath(ctx, true);
-    }
-
-    return ret;
+    return drawBeziersD(this, m_impl, ctx, n, pxpoints.points(), true);
 }
 
 void GiGraphics::clearCachedBitmap(bool clearAll)
@@ -1041,31 +1215,43 @@ float GiGraphics::getScreenDpi() const
 
 bool GiGraphics::rawLine(const GiContext* ctx, float x1, float y1, float x2, float y2)
 {
+    m_impl->stats.lines++;
+    m_impl->stats.points += 2;
     return m_impl->canvas && m_impl->canvas->rawLine(ctx, x1, y1, x2, y2);
 }
 
 bool GiGraphics::rawLines(const GiContext* ctx, const Point2d* pxs, int count)
 {
+    m_impl->stats.polylines++;
+    m_impl->stats.points += count;
     return m_impl->canvas && m_impl->canvas->rawLines(ctx, pxs, count);
 }
 
 bool GiGraphics::rawBeziers(const GiContext* ctx, const Point2d* pxs, int count)
 {
+    m_impl->stats.beziers++;
+    m_impl->stats.points += count;
     return m_impl->canvas && m_impl->canvas->rawBeziers(ctx, pxs, count);
 }
 
 bool GiGraphics::rawPolygon(const GiContext* ctx, const Point2d* pxs, int count)
 {
+    m_impl->stats.polygons++;
+    m_impl->stats.points += count;
     return m_impl->canvas && m_impl->canvas->rawPolygon(ctx, pxs, count);
 }
 
 bool GiGraphics::rawRect(const GiContext* ctx, float x, float y, float w, float h)
 {
+    m_impl->stats.rects++;
+    m_impl->stats.points += 2;
     return m_impl->canvas && m_impl->canvas->rawRect(ctx, x, y, w, h);
 }
 
 bool GiGraphics::rawEllipse(const GiContext* ctx, float x, float y, float w, float h)
 {
+    m_impl->stats.ellipses++;
+    m_impl->stats.points += 2;
     return m_impl->canvas && m_impl->canvas->rawEllipse(ctx, x, y, w, h);
 }
 
@@ -1076,21 +1262,25 @@ bool GiGraphics::rawBeginPath()
 
 bool GiGraphics::rawEndPath(const GiContext* ctx, bool fill)
 {
+    m_impl->stats.paths++;
     return m_impl->canvas && m_impl->canvas->rawEndPath(ctx, fill);
 }
 
 bool GiGraphics::rawMoveTo(float x, float y)
 {
+    m_impl->stats.points++;
     return m_impl->canvas && m_impl->canvas->rawMoveTo(x, y);
 }
 
 bool GiGraphics::rawLineTo(float x, float y)
 {
+    m_impl->stats.points++;
     return m_impl->canvas && m_impl->canvas->rawLineTo(x, y);
 }
 
 bool GiGraphics::rawBezierTo(float c1x, float c1y, float c2x, float c2y, float x, float y)
 {
+    m_impl->stats.points += 3;
     return m_impl->canvas && m_impl->canvas->rawBezierTo(c1x, c1y, c2x, c2y, x, y);
 }
 
@@ -0,0 +1,186 @@
+// giparallel.cpp: 实现多线程分块显示类 GiParallelRender
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+
+#include "giparallel.h"
+#include <string.h>
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+struct GiParallelRender::Worker
+{
+    GiParallelRender*   owner;
+    GiRasterCanvas      canvas;             //!< 本线程的画布，位图只覆盖当前图块
+    GiDrawStats         stats;              //!< 本线程的显示统计
+    int                 count;              //!< 本线程显示的图形个数
+#ifdef _WIN32
+    HANDLE              thread;
+#else
+    pthread_t           thread;
+#endif
+
+    Worker(GiParallelRender* p) : owner(p), count(0) {}
+
+    void prepare(GiRasterCanvas& dest)
+    {
+        canvas.setScreenDpi(dest.getScreenDpi());
+        canvas.setBkColor(dest.getBkColor());
+        canvas.gs().copy(dest.gs());            // 与串行显示使用相同的显示设置
+        canvas.gs().setIncrementalPan(false);   // 图块画布没有整个窗口的后备缓冲位图，平移无从复用
+        stats.reset();
+        count = 0;
+    }
+
+    void run()
+    {
+        const long n = (long)owner->m_rects.size();
+        long index;
+
+        while ((index = giInterlockedIncrement(&owner->m_next)) <= n)
+            drawTile(owner->m_rects[index - 1]);
+    }
+
+    void drawTile(const RECT_2D& rc)
+    {
+        GiRasterCanvas& dest = *owner->m_canvas;
+        int x = (int)rc.left;
+        int y = (int)rc.top;
+        int w = (int)rc.right - x;
+        int h = (int)rc.bottom - y;
+
+        if (!canvas.beginPaint(dest.xf(), x, y, w, h, false))
+            return;
+        copyPixels(canvas, dest, x, y, w, h);   // 在已有内容上叠加显示
+        count += owner->m_drawer->drawTile(canvas.gs());
+        stats.add(canvas.gs().stats());
+        canvas.endPaint();
+        copyPixels(dest, canvas, x, y, w, h);
+    }
+
+    static void copyPixels(GiRasterCanvas& dest, const GiRasterCanvas& src,
+                           int x, int y, int w, int h)
+    {
+        for (int row = y; row < y + h; row++) {
+            memcpy(dest.getPixels() + ((row - dest.getOriginY()) * dest.getWidth()
+                                       + x - dest.getOriginX()) * 4,
+                   src.getPixels() + ((row - src.getOriginY()) * src.getWidth()
+                                      + x - src.getOriginX()) * 4,
+                   w * 4);
+        }
+    }
+};
+
+#ifdef _WIN32
+static DWORD WINAPI workerProc(LPVOID param)
+{
+    ((GiParallelRender::Worker*)param)->run();
+    return 0;
+}
+#else
+static void* workerProc(void* param)
+{
+    ((GiParallelRender::Worker*)param)->run();
+    return NULL;
+}
+#endif
+
+GiParallelRender::GiParallelRender(int threads, int tilePixels)
+    : m_tilePixels(mgMax(tilePixels, 16)), m_next(0), m_canvas(NULL), m_drawer(NULL)
+{
+    setThreadCount(threads);
+}
+
+GiParallelRender::~GiParallelRender()
+{
+    for (size_t i = 0; i < m_workers.size(); i++)
+        delete m_workers[i];
+}
+
+int GiParallelRender::getProcessorCount()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    ::GetSystemInfo(&info);
+    return mgMax(1, (int)info.dwNumberOfProcessors);
+#else
+    return mgMax(1, (int)sysconf(_SC_NPROCESSORS_ONLN));
+#endif
+}
+
+void GiParallelRender::setThreadCount(int threads)
+{
+    m_threads = threads > 0 ? threads : getProcessorCount();
+}
+
+int GiParallelRender::draw(GiRasterCanvas& canvas, GiTileDrawer* drawer)
+{
+    if (!drawer || !canvas.gs().isDrawing() || !canvas.getPixels())
+        return 0;
+
+    // 图块网格在显示坐标系中对齐，与剪裁框求交
+    RECT_2D clipBox;
+    const int ts = m_tilePixels;
+    canvas.gs().getClipBox(clipBox);
+
+    const int left = mgMax(canvas.getOriginX(), (int)floorf(clipBox.left));
+    const int top = mgMax(canvas.getOriginY(), (int)floorf(clipBox.top));
+    const int right = mgMin(canvas.getOriginX() + canvas.getWidth(), (int)ceilf(clipBox.right));
+    const int bottom = mgMin(canvas.getOriginY() + canvas.getHeight(), (int)ceilf(clipBox.bottom));
+
+    m_rects.clear();
+    for (int y = (int)floorf((float)top / ts) * ts; y < bottom; y += ts) {
+        for (int x = (int)floorf((float)left / ts) * ts; x < right; x += ts) {
+            RECT_2D rc = {
+                (float)mgMax(x, left), (float)mgMax(y, top),
+                (float)mgMin(x + ts, right), (float)mgMin(y + ts, bottom)
+            };
+            if (rc.left < rc.right && rc.top < rc.bottom)
+                m_rects.push_back(rc);
+        }
+    }
+    if (m_rects.empty())
+        return 0;
+
+    const int n = mgMin(m_threads, (int)m_rects.size());
+    int i, count = 0;
+
+    while ((int)m_workers.size() < n)
+        m_workers.push_back(new Worker(this));
+    for (i = 0; i < n; i++)
+        m_workers[i]->prepare(canvas);
+
+    m_canvas = &canvas;
+    m_drawer = drawer;
+    m_next = 0;
+
+    // 当前线程也作为一个工作线程，创建线程失败时由其余线程完成
+    std::vector<bool> started(n, false);
+    for (i = 1; i < n; i++) {
+#ifdef _WIN32
+        m_workers[i]->thread = ::CreateThread(NULL, 0, workerProc, m_workers[i], 0, NULL);
+        started[i] = (m_workers[i]->thread != NULL);
+#else
+        started[i] = !pthread_create(&m_workers[i]->thread, NULL, workerProc, m_workers[i]);
+#endif
+    }
+    m_workers[0]->run();
+
+    for (i = 0; i < n; i++) {
+        if (started[i]) {
+#ifdef _WIN32
+            ::WaitForSingleObject(m_workers[i]->thread, INFINITE);
+            ::CloseHandle(m_workers[i]->thread);
+#else
+            pthread_join(m_workers[i]->thread, NULL);
+#endif
+        }
+        count += m_workers[i]->count;
+        canvas.gs().stats().add(m_workers[i]->stats);
+    }
+    m_canvas = NULL;
+    m_drawer = NULL;
+
+    return count;
+}
@@ -1,5 +1,5 @@
 //! \file giplclip.h
-//! \brief 定义多边形剪裁类 PolygonClip
+//! \brief 定义多边形剪裁类 PolygonClip 和贝塞尔曲线剪裁类 BezierClip
 // Copyright (c) 2004-2012, Zhang Yungui
 // License: LGPL, https://github.com/rhcad/touchvg
 
@@ -19,8 +19,8 @@ template<class T> inline static int getSize(T& arr)
 class PolygonClip
 {
     const Box2d     m_rect;         //!< 剪裁矩形
-    vector<Point2d> m_vs1;          //!< 剪裁交点缓冲
-    vector<Point2d> m_vs2;          //!< 剪裁交点缓冲
+    vector<Point2d>& m_vs1;         //!< 剪裁交点缓冲
+    vector<Point2d>& m_vs2;         //!< 剪裁交点缓冲
     bool            m_closed;       //!< 是否闭合
     
 public:
@@ -28,10 +28,13 @@ public:
     //! 构造函数
     /*!
         \param rect 剪裁矩形，必须为规范化的矩形
+        \param buf1 剪裁交点缓冲，可在多次剪裁间复用以免重复分配内存
+        \param buf2 剪裁交点缓冲，剪裁结果存放于此
         \param closed 将要传入的坐标序列是多边形还是折线
     */
-    PolygonClip(const Box2d& rect, bool closed = true)
-        : m_rect(rect), m_closed(closed)
+    PolygonClip(const Box2d& rect, vector<Point2d>& buf1, 
+        vector<Point2d>& buf2, bool closed = true)
+        : m_rect(rect), m_vs1(buf1), m_vs2(buf2), m_closed(closed)
     {
     }
     
@@ -213,4 +216,185 @@ private:
     }
 };
 
+//! 贝塞尔曲线剪裁类
+/*! 在中点递归二分与剪裁矩形边界相交的曲线段，控制点包络框在矩形内的子段原样输出，
+    跨越边界且足够小的子段也原样输出，完全在矩形外的子段对于开放曲线断开，
+    对于闭合曲线则用其端点在矩形边界上的投影点连线代替，矩形内的填充区域不变。
+    剪裁结果为路径节点(GiPathNode)序列，输出的曲线段数与可见部分的长度成正比。
+*/
+class BezierClip
+{
+    const Box2d     m_rect;         //!< 剪裁矩形
+    vector<Point2d>& m_pts;         //!< 剪裁结果的节点坐标
+    vector<char>&   m_types;        //!< 剪裁结果的节点类型
+    float           m_minSize;      //!< 跨越边界时不再细分的子段尺寸
+    bool            m_closed;       //!< 是否闭合
+    int             m_outside;      //!< 在矩形外的子段数
+    
+public:
+    
+    //! 构造函数
+    /*!
+        \param rect 剪裁矩形，必须为规范化的矩形
+        \param pts 剪裁结果的节点坐标缓冲，可在多次剪裁间复用以免重复分配内存
+        \param types 剪裁结果的节点类型缓冲，元素为 GiPathNode 值
+        \param closed 将要传入的曲线是否闭合
+        \param minSize 跨越边界的子段包络框尺寸不超过此值时不再细分
+    */
+    BezierClip(const Box2d& rect, vector<Point2d>& pts, 
+        vector<char>& types, bool closed, float minSize = 8.f)
+        : m_rect(rect), m_pts(pts), m_types(types)
+        , m_minSize(minSize), m_closed(closed), m_outside(0)
+    {
+    }
+    
+    //! 剪裁首尾相接的多段三次贝塞尔曲线
+    /*!
+        \param count 控制点个数，为 3n+1
+        \param points 控制点坐标数组, 个数为count
+        \return 是否有需要显示的内容。开放曲线要有可见的曲线段，闭合曲线只要有节点即可，
+            因为包住整个剪裁矩形的闭合曲线只剩下边界上的连线，仍需要填充
+    */
+    bool clip(int count, const Point2d* points)
+    {
+        m_pts.clear();
+        m_types.clear();
+        m_outside = 0;
+        
+        if (count < 4 || points == NULL)
+            return false;
+        for (int i = 0; i + 3 < count; i += 3)
+            clipSegment(points + i, 0);
+        
+        return m_closed ? getCount() > 1 : hasBeziers();
+    }
+    
+    //! 返回剪裁结果中的节点个数
+    int getCount() const
+    {
+        return getSize(m_pts);
+    }
+    
+    //! 返回剪裁结果中的节点坐标数组
+    const Point2d* getPoints() const
+    {
+        return m_pts.empty() ? (const Point2d*)0 : &m_pts.front();
+    }
+    
+    //! 返回剪裁结果中的节点类型数组，每个曲线段占3个 kGiBeziersTo 节点
+    const char* getTypes() const
+    {
+        return m_types.empty() ? (const char*)0 : &m_types.front();
+    }
+    
+    //! 返回是否有完全在矩形外而被断开或代替的子段
+    bool hasOutside() const
+    {
+        return m_outside > 0;
+    }
+    
+    //! 返回剪裁结果中是否有曲线段，没有时不需要显示边线
+    bool hasBeziers() const
+    {
+        for (int i = 0; i < getSize(m_types); i++) {
+            if (m_types[i] == kGiBeziersTo)
+                return true;
+        }
+        return false;
+    }
+    
+private:
+    
+    void operator=(const BezierClip&);
+
+    enum { MAX_DEPTH = 24 };
+    
+    void clipSegment(const Point2d* p, int depth)
+    {
+        Box2d box(4, p);
+        
+        if (!m_rect.isIntersect(box))
+        {
+            outputOutside(p);
+        }
+        else if (m_rect.contains(box) || depth >= MAX_DEPTH
+            || mgMax(box.width(), box.height()) <= m_minSize)
+        {
+            outputBezier(p);
+        }
+        else                                        // 在中点二分
+        {
+            Point2d sub[7];
+            Point2d m12((p[1].x + p[2].x) / 2, (p[1].y + p[2].y) / 2);
+            
+            sub[0] = p[0];
+            sub[1].set((p[0].x + p[1].x) / 2, (p[0].y + p[1].y) / 2);
+            sub[5].set((p[2].x + p[3].x) / 2, (p[2].y + p[3].y) / 2);
+            sub[2].set((sub[1].x + m12.x) / 2, (sub[1].y + m12.y) / 2);
+            sub[4].set((m12.x + sub[5].x) / 2, (m12.y + sub[5].y) / 2);
+            sub[3].set((sub[2].x + sub[4].x) / 2, (sub[2].y + sub[4].y) / 2);
+            sub[6] = p[3];
+            
+            clipSegment(sub, depth + 1);
+            clipSegment(sub + 3, depth + 1);
+        }
+    }
+    
+    bool isCurrent(const Point2d& pt) const
+    {
+        return !m_pts.empty() && m_pts.back().x == pt.x && m_pts.back().y == pt.y;
+    }
+    
+    void output(const Point2d& pt, GiPathNode type)
+    {
+        m_pts.push_back(pt);
+        m_types.push_back((char)type);
+    }
+    
+    void outputBezier(const Point2d* p)
+    {
+        if (!isCurrent(p[0]))                       // 断开后的新起点
+            output(p[0], m_closed && !m_pts.empty() ? kGiLineTo : kGiMoveTo);
+        output(p[1], kGiBeziersTo);
+        output(p[2], kGiBeziersTo);
+        output(p[3], kGiBeziersTo);
+    }
+    
+    void outputOutside(const Point2d* p)
+    {
+        m_outside++;
+        if (!m_closed)
+            return;
+        
+        Point2d pt(mgMax(m_rect.xmin, mgMin(m_rect.xmax, p[3].x)),
+                   mgMax(m_rect.ymin, mgMin(m_rect.ymax, p[3].y)));
+        int n = getSize(m_pts);
+        
+        if (n == 0)
+        {
+            output(Point2d(mgMax(m_rect.xmin, mgMin(m_rect.xmax, p[0].x)),
+                           mgMax(m_rect.ymin, mgMin(m_rect.ymax, p[0].y))), kGiMoveTo);
+            n++;
+        }
+        if (isCurrent(pt))
+            return;
+        if (n > 1 && m_types[n-1] == kGiLineTo      // 沿同一条边界时合并
+            && isOnSameSide(m_pts[n-2], m_pts[n-1], pt))
+        {
+            m_pts[n-1] = pt;
+        }
+        else
+        {
+            output(pt, kGiLineTo);
+        }
+    }
+    
+    bool isOnSameSide(const Point2d& p1, const Point2d& p2, const Point2d& p3) const
+    {
+        if (p1.x == p2.x && p2.x == p3.x && (p1.x == m_rect.xmin || p1.x == m_rect.xmax))
+            return true;
+        return p1.y == p2.y && p2.y == p3.y && (p1.y == m_rect.ymin || p1.y == m_rect.ymax);
+    }
+};
+
 #endif // __GEOMETRY_POLYGONCLIP_H_
@@ -0,0 +1,862 @@
+// giraster.cpp: 实现内存位图画布类 GiRasterCanvas
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+
+#include "giraster.h"
+#include <mgcurv.h>
+#include <vector>
+#include <map>
+#include <string.h>
+
+//! 内存位图
+struct GiRasterBitmap
+{
+    int     width;
+    int     height;
+    std::vector<unsigned char> pixels;
+
+    GiRasterBitmap() : width(0), height(0) {}
+
+    void clear()
+    {
+        width = height = 0;
+        std::vector<unsigned char>().swap(pixels);
+    }
+};
+
+//! GiRasterCanvas的内部实现类
+/*! 图元先累加到覆盖面积缓冲中，再按覆盖率混合到位图上。
+    面积缓冲只分配图元包络框与剪裁框相交的部分，每行累加的和即为像素覆盖率，
+    各轮廓按非零环绕规则合并，因此线段四边形和连接圆重叠处不会重复混合。
+*/
+class GiRasterCanvasImpl
+{
+public:
+    GiRasterCanvas* m_this;
+    GiContext       m_context;          //!< 当前绘图参数
+    GiColor         m_bkcolor;          //!< 背景色
+    float           m_dpi;              //!< 显示分辨率
+    float           m_flatness;         //!< 曲线离散为折线的最大误差，像素
+    bool            m_antiAlias;        //!< 是否反走样
+    GiRasterBitmap  m_bmp;              //!< 绘图位图
+    int             m_ox, m_oy;         //!< 绘图位图左上角的显示坐标
+    GiRasterBitmap  m_cachedBmp[2];     //!< 后备缓冲位图
+    std::map<int, GiRasterBitmap> m_tiles;  //!< 图块位图
+    int             m_lastTile;         //!< 最近分配的图块位图句柄
+    int             m_clip[4];          //!< 剪裁框: 左, 上, 右, 下
+
+    std::vector<float> m_acc;           //!< 覆盖面积缓冲
+    int             m_ax, m_ay;         //!< 面积缓冲的左上角像素位置
+    int             m_aw, m_ah;         //!< 面积缓冲的像素宽高(每行多2个单元)
+
+    std::vector<Point2d> m_pts;         //!< 离散后的折线点
+    std::vector<Point2d> m_dash;        //!< 虚线中的一段实线
+    std::vector<Point2d> m_path;        //!< 路径各子路径的离散点
+    std::vector<int> m_subpaths;        //!< 子路径: 起始序号, 闭合标志(交替存放)
+
+    GiRasterCanvasImpl(GiRasterCanvas* owner)
+        : m_this(owner), m_bkcolor(GiColor::White()), m_dpi(96), m_flatness(0.25f)
+        , m_antiAlias(true), m_ox(0), m_oy(0), m_lastTile(0), m_ax(0), m_ay(0), m_aw(0), m_ah(0)
+    {
+        m_clip[0] = m_clip[1] = m_clip[2] = m_clip[3] = 0;
+    }
+
+    unsigned char* pixel(int x, int y)
+    {
+        return &m_bmp.pixels[((y - m_oy) * m_bmp.width + x - m_ox) * 4];
+    }
+
+    const GiContext* useContext(const GiContext* ctx)
+    {
+        if (ctx && ctx != &m_context)
+            m_context = *ctx;
+        return &m_context;
+    }
+
+    bool hasStroke(const GiContext* ctx) const
+    {
+        return !ctx->isNullLine() && ctx->getLineColor().a > 0;
+    }
+
+    bool hasFill(const GiContext* ctx) const
+    {
+        return ctx->hasFillColor();
+    }
+
+    float penWidth(const GiContext* ctx) const
+    {
+        return m_this->gs().calcPenWidth(ctx->getLineWidth(), ctx->isAutoScale());
+    }
+
+    // 面积缓冲
+    bool beginRegion(const Box2d& box);
+    void addLine(float x0, float y0, float x1, float y1);
+    void clipLine(float x0, float y0, float x1, float y1);
+    void clipRight(float x0, float y0, float x1, float y1);
+    void addPolygon(const Point2d* pts, int n);
+    void accumulate(float x0, float y0, float x1, float y1);
+    void fillRegion(const GiColor& color);
+
+    // 图元
+    bool fillPolygons(const GiContext* ctx, const Point2d* pts, int n,
+                      const int* subpaths = NULL, int subcount = 0);
+    bool strokeLines(const GiContext* ctx, const Point2d* pts, int n, bool closed,
+                     const int* subpaths = NULL, int subcount = 0);
+    void addStroke(const Point2d* pts, int n, bool closed, float hw);
+    void addSegments(const Point2d* pts, int n, float hw);
+    void addJoin(const Point2d& pt, float hw);
+    void flattenBezier(std::vector<Point2d>& pts, const Point2d& p1,
+                       const Point2d& p2, const Point2d& p3);
+
+    void blitBitmap(const GiRasterBitmap& src, int x, int y);
+    void copyBitmap(GiRasterBitmap& dest, int x, int y, int w, int h) const;
+};
+
+static inline unsigned char blendByte(int dst, int src, int alpha)
+{
+    return (unsigned char)((dst * (255 - alpha) + src * alpha + 127) / 255);
+}
+
+//! 将颜色按透明度 alpha (0到255) 混合到像素上
+static inline void blendPixel(unsigned char* p, const GiColor& c, int alpha)
+{
+    if (alpha >= 255) {
+        p[0] = c.r;
+        p[1] = c.g;
+        p[2] = c.b;
+        p[3] = 255;
+    }
+    else if (p[3] == 255) {
+        p[0] = blendByte(p[0], c.r, alpha);
+        p[1] = blendByte(p[1], c.g, alpha);
+        p[2] = blendByte(p[2], c.b, alpha);
+    }
+    else if (alpha > 0) {
+        int da = p[3] * (255 - alpha) / 255;
+        int a = alpha + da;
+
+        p[0] = (unsigned char)((c.r * alpha + p[0] * da + a / 2) / a);
+        p[1] = (unsigned char)((c.g * alpha + p[1] * da + a / 2) / a);
+        p[2] = (unsigned char)((c.b * alpha + p[2] * da + a / 2) / a);
+        p[3] = (unsigned char)a;
+    }
+}
+
+bool GiRasterCanvasImpl::beginRegion(const Box2d& box)
+{
+    int left = mgMax(m_clip[0], (int)floorf(box.xmin));
+    int top = mgMax(m_clip[1], (int)floorf(box.ymin));
+    int right = mgMin(m_clip[2], (int)ceilf(box.xmax));
+    int bottom = mgMin(m_clip[3], (int)ceilf(box.ymax));
+
+    if (box.isNull() || left >= right || top >= bottom)
+        return false;
+
+    m_ax = left;
+    m_ay = top;
+    m_aw = right - left;
+    m_ah = bottom - top;
+
+    size_t size = (size_t)(m_aw + 2) * m_ah;
+    if (m_acc.size() < size)
+        m_acc.resize(size, 0.f);
+
+    return true;
+}
+
+void GiRasterCanvasImpl::addLine(float x0, float y0, float x1, float y1)
+{
+    x0 -= m_ax; x1 -= m_ax;
+    y0 -= m_ay; y1 -= m_ay;
+
+    if ((y0 <= 0 && y1 <= 0) || (y0 >= m_ah && y1 >= m_ah) || y0 == y1)
+        return;
+    clipLine(x0, y0, x1, y1);
+}
+
+// 在左边界处拆分线段(保持线段方向)，左侧部分移到左边界
+void GiRasterCanvasImpl::clipLine(float x0, float y0, float x1, float y1)
+{
+    if (x0 < 0 && x1 < 0) {
+        accumulate(0, y0, 0, y1);
+    }
+    else if (x0 < 0 || x1 < 0) {
+        float y = y0 + (y1 - y0) * (0 - x0) / (x1 - x0);
+        if (x0 < 0) {
+            accumulate(0, y0, 0, y);
+            clipRight(0, y, x1, y1);
+        }
+        else {
+            clipRight(x0, y0, 0, y);
+            accumulate(0, y, 0, y1);
+        }
+    }
+    else {
+        clipRight(x0, y0, x1, y1);
+    }
+}
+
+// 在右边界处拆分线段，右侧的部分不影响区域内的覆盖率
+void GiRasterCanvasImpl::clipRight(float x0, float y0, float x1, float y1)
+{
+    const float w = (float)m_aw;
+
+    if (x0 <= w && x1 <= w) {
+        accumulate(x0, y0, x1, y1);
+    }
+    else if (x0 <= w || x1 <= w) {
+        float y = y0 + (y1 - y0) * (w - x0) / (x1 - x0);
+        if (x0 > w)
+            accumulate(w, y, x1, y1);
+        else
+            accumulate(x0, y0, w, y);
+    }
+}
+
+// 按 font-rs 的做法累加线段左右两侧的有向面积，行内前缀和即为覆盖率
+void GiRasterCanvasImpl::accumulate(float x0, float y0, float x1, float y1)
+{
+    if (fabsf(y0 - y1) < 1e-6f)
+        return;
+
+    float dir = 1.f;
+    if (y0 > y1) {
+        dir = -1.f;
+        mgSwap(x0, x1);
+        mgSwap(y0, y1);
+    }
+
+    const int stride = m_aw + 2;
+    const float dxdy = (x1 - x0) / (y1 - y0);
+    float x = x0;
+    int ystart = (int)floorf(y0);
+    int yend = mgMin(m_ah, (int)ceilf(y1));
+
+    if (y0 < 0) {
+        x -= y0 * dxdy;
+        ystart = 0;
+    }
+    for (int y = ystart; y < yend; y++) {
+        float* line = &m_acc[y * stride];
+        float dy = mgMin((float)(y + 1), y1) - mgMax((float)y, y0);
+        float xnext = x + dxdy * dy;
+        float d = dy * dir;
+        float xl = mgMax(0.f, mgMin(x, xnext));
+        float xr = mgMin((float)m_aw, mgMax(x, xnext));
+        float xlfloor = floorf(xl);
+        int xli = (int)xlfloor;
+        int xri = (int)ceilf(xr);
+
+        if (xri <= xli + 1) {
+            float xmf = 0.5f * (xl + xr) - xlfloor;
+            line[xli] += d - d * xmf;
+            line[xli + 1] += d * xmf;
+        }
+        else {
+            float s = 1.f / (xr - xl);
+            float xlf = xl - xlfloor;
+            float a0 = 0.5f * s * (1.f - xlf) * (1.f - xlf);
+            float xrf = xr - (float)xri + 1.f;
+            float am = 0.5f * s * xrf * xrf;
+
+            line[xli] += d * a0;
+            if (xri == xli + 2) {
+                line[xli + 1] += d * (1.f - a0 - am);
+            }
+            else {
+                float a1 = s * (1.5f - xlf);
+                line[xli + 1] += d * (a1 - a0);
+                for (int xi = xli + 2; xi < xri - 1; xi++)
+                    line[xi] += d * s;
+                float a2 = a1 + (float)(xri - xli - 3) * s;
+                line[xri - 1] += d * (1.f - a2 - am);
+            }
+            line[xri] += d * am;
+        }
+        x = xnext;
+    }
+}
+
+void GiRasterCanvasImpl::addPolygon(const Point2d* pts, int n)
+{
+    for (int i = 0; i < n; i++) {
+        const Point2d& a = pts[i];
+        const Point2d& b = pts[i + 1 < n ? i + 1 : 0];
+        addLine(a.x, a.y, b.x, b.y);
+    }
+}
+
+void GiRasterCanvasImpl::fillRegion(const GiColor& color)
+{
+    const int stride = m_aw + 2;
+    const float alpha = (float)color.a;
+
+    for (int y = 0; y < m_ah; y++) {
+        float* line = &m_acc[y * stride];
+        unsigned char* p = pixel(m_ax, m_ay + y);
+        float sum = 0;
+
+        for (int x = 0; x < m_aw; x++, p += 4) {
+            sum += line[x];
+            line[x] = 0;
+
+            float cover = mgMin(fabsf(sum), 1.f);
+            if (!m_antiAlias)
+                cover = cover < 0.5f ? 0.f : 1.f;
+            if (cover > 0.002f)
+                blendPixel(p, color, (int)(cover * alpha + 0.5f));
+        }
+        line[m_aw] = 0;
+        line[m_aw + 1] = 0;
+    }
+}
+
+bool GiRasterCanvasImpl::fillPolygons(const GiContext* ctx, const Point2d* pts, int n,
+                                      const int* subpaths, int subcount)
+{
+    if (n < 3 || !beginRegion(Box2d(n, pts)))
+        return false;
+
+    if (!subpaths) {
+        addPolygon(pts, n);
+    }
+    else {
+        for (int i = 0; i < subcount; i += 2) {
+            int end = i + 2 < subcount ? subpaths[i + 2] : n;
+            addPolygon(pts + subpaths[i], end - subpaths[i]);
+        }
+    }
+    fillRegion(m_this->gs().calcPenColor(ctx->getFillColor()));
+
+    return true;
+}
+
+bool GiRasterCanvasImpl::strokeLines(const GiContext* ctx, const Point2d* pts, int n, bool closed,
+                                     const int* subpaths, int subcount)
+{
+    const float hw = mgMax(penWidth(ctx), 1.f) * 0.5f;
+    Box2d box(n, pts);
+
+    box.inflate(hw + 1);
+    if (n < 2 || !beginRegion(box))
+        return false;
+
+    if (!subpaths) {
+        addStroke(pts, n, closed, hw);
+    }
+    else {
+        for (int i = 0; i < subcount; i += 2) {
+            int end = i + 2 < subcount ? subpaths[i + 2] : n;
+            addStroke(pts + subpaths[i], end - subpaths[i], subpaths[i + 1] != 0, hw);
+        }
+    }
+    fillRegion(m_this->gs().calcPenColor(ctx->getLineColor()));
+
+    return true;
+}
+
+static int getDashPattern(int style, const float*& pattern)
+{
+    // 各段长度以线宽为单位
+    static const float dash[] = { 4, 2 };
+    static const float dot[] = { 1, 2 };
+    static const float dashdot[] = { 4, 2, 1, 2 };
+    static const float dashdotdot[] = { 4, 2, 1, 2, 1, 2 };
+
+    switch (style) {
+        case kGiLineDash: pattern = dash; return 2;
+        case kGiLineDot: pattern = dot; return 2;
+        case kGiLineDashDot: pattern = dashdot; return 4;
+        case kGiLineDashDotdot: pattern = dashdotdot; return 6;
+    }
+    pattern = NULL;
+    return 0;
+}
+
+void GiRasterCanvasImpl::addStroke(const Point2d* pts, int n, bool closed, float hw)
+{
+    const float* pattern;
+    const int count = getDashPattern(m_context.getLineStyle(), pattern);
+
+    if (n < 2)
+        return;
+    if (count == 0) {
+        addSegments(pts, n, hw);
+        if (closed) {
+            const Point2d seg[2] = { pts[n - 1], pts[0] };
+            addSegments(seg, 2, hw);
+            addJoin(pts[0], hw);
+            addJoin(pts[n - 1], hw);
+        }
+        return;
+    }
+
+    // 按线型将折线分为多段实线，虚线的相位在各段折线间连续
+    const float unit = mgMax(hw * 2.f, 1.5f);
+    int index = 0;
+    float remain = pattern[0] * unit;
+    const int segs = closed ? n : n - 1;
+
+    m_dash.clear();
+    m_dash.push_back(pts[0]);
+    for (int i = 0; i < segs; i++) {
+        Point2d a = pts[i];
+        const Point2d& b = pts[i + 1 < n ? i + 1 : 0];
+        float len = a.distanceTo(b);
+
+        while (len > remain) {
+            a = a + (b - a) * (remain / len);
+            len -= remain;
+            if (index % 2 == 0) {
+                m_dash.push_back(a);
+                addSegments(&m_dash.front(), (int)m_dash.size(), hw);
+            }
+            m_dash.clear();
+            m_dash.push_back(a);
+            index = (index + 1) % count;
+            remain = pattern[index] * unit;
+        }
+        remain -= len;
+        m_dash.push_back(b);
+    }
+    if (index % 2 == 0)
+        addSegments(&m_dash.front(), (int)m_dash.size(), hw);
+}
+
+// 各线段四边形和连接圆都按相同方向环绕，重叠处按非零规则合并
+void GiRasterCanvasImpl::addSegments(const Point2d* pts, int n, float hw)
+{
+    for (int i = 0; i + 1 < n; i++) {
+        const Point2d& a = pts[i];
+        const Point2d& b = pts[i + 1];
+        Vector2d vec(b - a);
+        float len = vec.length();
+
+        if (len < 1e-4f)
+            continue;
+        vec = vec * (hw / len);
+
+        const Point2d quad[4] = {
+            Point2d(a.x - vec.y, a.y + vec.x), Point2d(b.x - vec.y, b.y + vec.x),
+            Point2d(b.x + vec.y, b.y - vec.x), Point2d(a.x + vec.y, a.y - vec.x)
+        };
+        addPolygon(quad, 4);
+        if (i > 0)
+            addJoin(a, hw);
+    }
+}
+
+void GiRasterCanvasImpl::addJoin(const Point2d& pt, float hw)
+{
+    if (hw < 1.f)                               // 细线的连接处不明显
+        return;
+
+    const int n = mgMax(8, mgMin(64, (int)(hw * 2)));
+    Point2d circle[64];
+
+    for (int i = 0; i < n; i++) {               // 顺时针，与线段四边形同向
+        float angle = -_M_2PI * i / n;
+        circle[i].set(pt.x + hw * cosf(angle), pt.y + hw * sinf(angle));
+    }
+    addPolygon(circle, n);
+}
+
+void GiRasterCanvasImpl::flattenBezier(std::vector<Point2d>& pts, const Point2d& p1,
+                                       const Point2d& p2, const Point2d& p3)
+{
+    const Point2d seg[4] = { pts.back(), p1, p2, p3 };
+    const size_t start = pts.size() - 1;
+
+    pts.resize(start + 1 + mgBezierSegments(seg, m_flatness));
+    mgBeziersToLines(&pts[start], (Int32)(pts.size() - start), 4, seg, m_flatness);
+}
+
+void GiRasterCanvasImpl::blitBitmap(const GiRasterBitmap& src, int x, int y)
+{
+    int left = mgMax(m_clip[0], x);
+    int top = mgMax(m_clip[1], y);
+    int right = mgMin(m_clip[2], x + src.width);
+    int bottom = mgMin(m_clip[3], y + src.height);
+
+    if (right <= left || bottom <= top)         // 与剪裁框不相交
+        return;
+    for (int row = top; row < bottom; row++) {
+        memcpy(pixel(left, row),
+               &src.pixels[((row - y) * src.width + left - x) * 4],
+               (right - left) * 4);
+    }
+}
+
+void GiRasterCanvasImpl::copyBitmap(GiRasterBitmap& dest, int x, int y, int w, int h) const
+{
+    int left = mgMax(m_ox, x);
+    int top = mgMax(m_oy, y);
+    int right = mgMin(m_ox + m_bmp.width, x + w);
+    int bottom = mgMin(m_oy + m_bmp.height, y + h);
+
+    dest.width = w;
+    dest.height = h;
+    dest.pixels.assign((size_t)w * h * 4, 0);
+
+    if (right <= left || bottom <= top)         // 与画布不相交，结果为全透明
+        return;
+    for (int row = top; row < bottom; row++) {
+        memcpy(&dest.pixels[((row - y) * w + left - x) * 4],
+               &m_bmp.pixels[((row - m_oy) * m_bmp.width + left - m_ox) * 4],
+               (right - left) * 4);
+    }
+}
+
+GiRasterCanvas::GiRasterCanvas() : _gs(&_xf)
+{
+    m_draw = new GiRasterCanvasImpl(this);
+    _gs._setCanvas(this);
+    _xf.setResolution(m_draw->m_dpi);
+}
+
+GiRasterCanvas::~GiRasterCanvas()
+{
+    delete m_draw;
+}
+
+bool GiRasterCanvas::beginPaint(int width, int height, bool clear)
+{
+    if (width < 1 || height < 1 || _gs.isDrawing())
+        return false;
+
+    _xf.setWndSize(width, height);
+    return beginPaintRect(0, 0, width, height, clear);
+}
+
+bool GiRasterCanvas::beginPaint(const GiTransform& xf, int x, int y,
+                                int width, int height, bool clear)
+{
+    if (width < 1 || height < 1 || _gs.isDrawing())
+        return false;
+
+    _xf.copy(xf);
+    return beginPaintRect(x, y, width, height, clear);
+}
+
+bool GiRasterCanvas::beginPaintRect(int x, int y, int width, int height, bool clear)
+{
+    GiRasterBitmap& bmp = m_draw->m_bmp;
+
+    if (bmp.width != width || bmp.height != height
+        || m_draw->m_ox != x || m_draw->m_oy != y) {
+        bmp.width = width;
+        bmp.height = height;
+        bmp.pixels.resize((size_t)width * height * 4);
+        m_draw->m_ox = x;
+        m_draw->m_oy = y;
+        clearCachedBitmap(true);
+    }
+
+    RECT_2D clipBox = { (float)x, (float)y, (float)(x + width), (float)(y + height) };
+    _gs._beginPaint(clipBox);
+    _clipBoxChanged(clipBox);
+    if (clear)
+        clearWindow();
+
+    return true;
+}
+
+void GiRasterCanvas::endPaint()
+{
+    _gs._endPaint();
+}
+
+int GiRasterCanvas::getWidth() const
+{
+    return m_draw->m_bmp.width;
+}
+
+int GiRasterCanvas::getHeight() const
+{
+    return m_draw->m_bmp.height;
+}
+
+int GiRasterCanvas::getOriginX() const
+{
+    return m_draw->m_ox;
+}
+
+int GiRasterCanvas::getOriginY() const
+{
+    return m_draw->m_oy;
+}
+
+const unsigned char* GiRasterCanvas::getPixels() const
+{
+    return m_draw->m_bmp.pixels.empty() ? NULL : &m_draw->m_bmp.pixels.front();
+}
+
+unsigned char* GiRasterCanvas::getPixels()
+{
+    return m_draw->m_bmp.pixels.empty() ? NULL : &m_draw->m_bmp.pixels.front();
+}
+
+void GiRasterCanvas::setScreenDpi(float dpi)
+{
+    m_draw->m_dpi = dpi;
+    _xf.setResolution(dpi);
+}
+
+void GiRasterCanvas::setFlatness(float tol)
+{
+    m_draw->m_flatness = mgMax(tol, 0.05f);
+}
+
+float GiRasterCanvas::getFlatness() const
+{
+    return m_draw->m_flatness;
+}
+
+float GiRasterCanvas::getScreenDpi() const
+{
+    return m_draw->m_dpi;
+}
+
+GiColor GiRasterCanvas::getBkColor() const
+{
+    return m_draw->m_bkcolor;
+}
+
+GiColor GiRasterCanvas::setBkColor(const GiColor& color)
+{
+    GiColor old(m_draw->m_bkcolor);
+    m_draw->m_bkcolor = color;
+    return old;
+}
+
+const GiContext* GiRasterCanvas::getCurrentContext() const
+{
+    return &m_draw->m_context;
+}
+
+void GiRasterCanvas::_clipBoxChanged(const RECT_2D& clipBox)
+{
+    int* clip = m_draw->m_clip;
+
+    clip[0] = mgMax(m_draw->m_ox, (int)floorf(clipBox.left));
+    clip[1] = mgMax(m_draw->m_oy, (int)floorf(clipBox.top));
+    clip[2] = mgMin(m_draw->m_ox + m_draw->m_bmp.width, (int)ceilf(clipBox.right));
+    clip[3] = mgMin(m_draw->m_oy + m_draw->m_bmp.height, (int)ceilf(clipBox.bottom));
+}
+
+void GiRasterCanvas::_antiAliasModeChanged(bool antiAlias)
+{
+    m_draw->m_antiAlias = antiAlias;
+}
+
+void GiRasterCanvas::clearWindow()
+{
+    const int* clip = m_draw->m_clip;
+    const GiColor& c = m_draw->m_bkcolor;
+
+    for (int y = clip[1]; y < clip[3]; y++) {
+        unsigned char* p = m_draw->pixel(clip[0], y);
+        for (int x = clip[0]; x < clip[2]; x++, p += 4) {
+            p[0] = c.r;
+            p[1] = c.g;
+            p[2] = c.b;
+            p[3] = c.a;
+        }
+    }
+}
+
+void GiRasterCanvas::clearCachedBitmap(bool clearAll)
+{
+    m_draw->m_cachedBmp[0].clear();
+    if (clearAll)
+        m_draw->m_cachedBmp[1].clear();
+}
+
+bool GiRasterCanvas::drawCachedBitmap(float x, float y, bool secondBmp)
+{
+    return drawCachedBitmap2(this, x, y, secondBmp);
+}
+
+bool GiRasterCanvas::drawCachedBitmap2(const GiCanvas* p, float x, float y, bool secondBmp)
+{
+    if (!p || p->getCanvasType() != getCanvasType() || !_gs.isDrawing())
+        return false;
+
+    const GiRasterCanvas* canvas = static_cast<const GiRasterCanvas*>(p);
+    const GiRasterBitmap& bmp = canvas->m_draw->m_cachedBmp[secondBmp ? 1 : 0];
+    bool ret = bmp.width == getWidth() && bmp.height == getHeight();
+
+    if (ret)
+        m_draw->blitBitmap(bmp, m_draw->m_ox + mgRound(x), m_draw->m_oy + mgRound(y));
+
+    return ret;
+}
+
+void GiRasterCanvas::saveCachedBitmap(bool secondBmp)
+{
+    m_draw->copyBitmap(m_draw->m_cachedBmp[secondBmp ? 1 : 0],
+                       m_draw->m_ox, m_draw->m_oy, getWidth(), getHeight());
+}
+
+bool GiRasterCanvas::hasCachedBitmap(bool secondBmp) const
+{
+    return m_draw->m_cachedBmp[secondBmp ? 1 : 0].width > 0;
+}
+
+int GiRasterCanvas::saveTileBitmap(int x, int y, int w, int h)
+{
+    if (w < 1 || h < 1 || m_draw->m_bmp.pixels.empty())
+        return 0;
+
+    int handle = ++m_draw->m_lastTile;
+    m_draw->copyBitmap(m_draw->m_tiles[handle], x, y, w, h);
+
+    return handle;
+}
+
+bool GiRasterCanvas::drawTileBitmap(int handle, float x, float y)
+{
+    std::map<int, GiRasterBitmap>::const_iterator it = m_draw->m_tiles.find(handle);
+    bool ret = (it != m_draw->m_tiles.end() && _gs.isDrawing());
+
+    if (ret)
+        m_draw->blitBitmap(it->second, mgRound(x), mgRound(y));
+
+    return ret;
+}
+
+void GiRasterCanvas::releaseTileBitmap(int handle)
+{
+    m_draw->m_tiles.erase(handle);
+}
+
+bool GiRasterCanvas::rawLine(const GiContext* ctx, float x1, float y1, float x2, float y2)
+{
+    const Point2d pts[2] = { Point2d(x1, y1), Point2d(x2, y2) };
+    return rawLines(ctx, pts, 2);
+}
+
+bool GiRasterCanvas::rawLines(const GiContext* ctx, const Point2d* pxs, int count)
+{
+    ctx = m_draw->useContext(ctx);
+    return pxs && m_draw->hasStroke(ctx)
+        && m_draw->strokeLines(ctx, pxs, count, false);
+}
+
+bool GiRasterCanvas::rawBeziers(const GiContext* ctx, const Point2d* pxs, int count)
+{
+    ctx = m_draw->useContext(ctx);
+    if (!pxs || count < 4 || !m_draw->hasStroke(ctx))
+        return false;
+
+    std::vector<Point2d>& pts = m_draw->m_pts;
+
+    pts.clear();
+    pts.push_back(pxs[0]);
+    for (int i = 1; i + 2 < count; i += 3)
+        m_draw->flattenBezier(pts, pxs[i], pxs[i + 1], pxs[i + 2]);
+
+    return m_draw->strokeLines(ctx, &pts.front(), (int)pts.size(), false);
+}
+
+bool GiRasterCanvas::rawPolygon(const GiContext* ctx, const Point2d* pxs, int count)
+{
+    ctx = m_draw->useContext(ctx);
+    if (!pxs || count < 2)
+        return false;
+
+    bool ret = false;
+
+    if (m_draw->hasFill(ctx))
+        ret = m_draw->fillPolygons(ctx, pxs, count);
+    if (m_draw->hasStroke(ctx))
+        ret = m_draw->strokeLines(ctx, pxs, count, true) || ret;
+
+    return ret;
+}
+
+bool GiRasterCanvas::rawRect(const GiContext* ctx, float x, float y, float w, float h)
+{
+    const Point2d pts[4] = {
+        Point2d(x, y), Point2d(x + w, y), Point2d(x + w, y + h), Point2d(x, y + h)
+    };
+    return rawPolygon(ctx, pts, 4);
+}
+
+bool GiRasterCanvas::rawEllipse(const GiContext* ctx, float x, float y, float w, float h)
+{
+    const float rx = fabsf(w) * 0.5f;
+    const float ry = fabsf(h) * 0.5f;
+    const Point2d center(x + w * 0.5f, y + h * 0.5f);
+    const int n = mgEllipseToLines(NULL, 0, center, rx, ry, m_draw->m_flatness);
+    std::vector<Point2d>& pts = m_draw->m_pts;
+
+    if (n < 3)
+        return false;
+    pts.resize(n);
+    mgEllipseToLines(&pts.front(), n, center, rx, ry, m_draw->m_flatness);
+
+    return rawPolygon(ctx, &pts.front(), n);
+}
+
+bool GiRasterCanvas::rawBeginPath()
+{
+    m_draw->m_path.clear();
+    m_draw->m_subpaths.clear();
+    return true;
+}
+
+bool GiRasterCanvas::rawEndPath(const GiContext* ctx, bool fill)
+{
+    ctx = m_draw->useContext(ctx);
+
+    std::vector<Point2d>& path = m_draw->m_path;
+    std::vector<int>& subpaths = m_draw->m_subpaths;
+    const int n = (int)path.size();
+    bool ret = false;
+
+    if (n < 2)
+        return false;
+    if (fill && m_draw->hasFill(ctx)) {
+        ret = m_draw->fillPolygons(ctx, &path.front(), n,
+                                   &subpaths.front(), (int)subpaths.size());
+    }
+    if (m_draw->hasStroke(ctx)) {
+        ret = m_draw->strokeLines(ctx, &path.front(), n, false,
+                                  &subpaths.front(), (int)subpaths.size()) || ret;
+    }
+
+    return ret;
+}
+
+bool GiRasterCanvas::rawMoveTo(float x, float y)
+{
+    m_draw->m_subpaths.push_back((int)m_draw->m_path.size());
+    m_draw->m_subpaths.push_back(0);
+    m_draw->m_path.push_back(Point2d(x, y));
+    return true;
+}
+
+bool GiRasterCanvas::rawLineTo(float x, float y)
+{
+    if (m_draw->m_path.empty())
+        return false;
+    m_draw->m_path.push_back(Point2d(x, y));
+    return true;
+}
+
+bool GiRasterCanvas::rawBezierTo(float c1x, float c1y, float c2x, float c2y, float x, float y)
+{
+    if (m_draw->m_path.empty())
+        return false;
+    m_draw->flattenBezier(m_draw->m_path, Point2d(c1x, c1y), Point2d(c2x, c2y), Point2d(x, y));
+    return true;
+}
+
+bool GiRasterCanvas::rawClosePath()
+{
+    if (m_draw->m_subpaths.empty())
+        return false;
+    m_draw->m_subpaths.back() = 1;
+    return true;
+}
@@ -0,0 +1,156 @@
+// gitiles.cpp: 实现多分辨率图块缓存类 GiTileCache
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+
+#include "gitiles.h"
+#include "gicanvas.h"
+
+GiTileCache::GiTileCache(int tilePixels, long maxBytes)
+    : m_tilePixels(mgMax(tilePixels, 16)), m_maxBytes(maxBytes), m_usedBytes(0)
+    , m_margin(4), m_unsupported(false), m_canvas(NULL)
+{
+}
+
+GiTileCache::~GiTileCache()
+{
+    clear();
+}
+
+void GiTileCache::setBudget(long maxBytes)
+{
+    m_maxBytes = maxBytes;
+    evict();
+}
+
+void GiTileCache::releaseTile(TileList::iterator it)
+{
+    if (m_canvas)
+        m_canvas->releaseTileBitmap(it->handle);
+    m_usedBytes -= it->bytes;
+    m_map.erase(it->key);
+    m_tiles.erase(it);
+}
+
+void GiTileCache::evict()
+{
+    while (m_usedBytes > m_maxBytes && !m_tiles.empty()) {
+        TileList::iterator it = m_tiles.end();
+        releaseTile(--it);
+    }
+}
+
+void GiTileCache::clear()
+{
+    while (!m_tiles.empty())
+        releaseTile(m_tiles.begin());
+    m_unsupported = false;
+}
+
+int GiTileCache::invalidate(const Box2d& rectWorld)
+{
+    int count = 0;
+
+    for (TileList::iterator it = m_tiles.begin(); it != m_tiles.end(); ) {
+        TileList::iterator cur = it++;
+        Box2d rect(cur->rectW);
+
+        rect.inflate(m_margin / cur->scale);
+        if (rect.isIntersect(rectWorld)) {
+            releaseTile(cur);
+            count++;
+        }
+    }
+
+    return count;
+}
+
+int GiTileCache::draw(GiGraphics& gs, GiTileDrawer* drawer)
+{
+    GiCanvas* canvas = gs.getCanvas();
+    if (!drawer || !canvas || !gs.isDrawing())
+        return 0;
+
+    if (m_canvas != canvas) {
+        clear();
+        m_canvas = canvas;
+    }
+    if (m_unsupported)
+        return drawer->drawTile(gs);
+
+    const GiTransform& xf = gs.xf();
+    const Matrix2d& mat = xf.worldToDisplay();
+    const float scale = fabsf(mat.m11);
+    const float tsize = (float)m_tilePixels;
+    RECT_2D clipBox;
+
+    if (scale < _MGZERO || !mgIsZero(mat.m12) || !mgIsZero(mat.m21))
+        return drawer->drawTile(gs);
+    gs.getClipBox(clipBox);
+
+    // 图块网格在去掉平移量的像素坐标系中对齐，平移后网格不变
+    const Box2d wnd(0.f, 0.f, (float)xf.getWidth(), (float)xf.getHeight());
+    const int level = (int)floorf(logf(scale) / logf(2.f) * 16.f + 0.5f);
+    const int x1 = (int)floorf((clipBox.left - mat.dx) / tsize);
+    const int y1 = (int)floorf((clipBox.top - mat.dy) / tsize);
+    const int x2 = (int)floorf((clipBox.right - mat.dx - 0.5f) / tsize);
+    const int y2 = (int)floorf((clipBox.bottom - mat.dy - 0.5f) / tsize);
+    int count = 0;
+    TileKey key;
+
+    key.level = level;
+    for (key.ty = y1; key.ty <= y2; key.ty++) {
+        for (key.tx = x1; key.tx <= x2; key.tx++) {
+            float x = key.tx * tsize + mat.dx;
+            float y = key.ty * tsize + mat.dy;
+            TileMap::iterator found = m_map.find(key);
+
+            if (found != m_map.end()) {
+                TileList::iterator it = found->second;
+
+                if (mgIsZero(it->scale / scale - 1.f)
+                    && canvas->drawTileBitmap(it->handle, x - it->fx, y - it->fy)) {
+                    m_tiles.splice(m_tiles.begin(), m_tiles, it);
+                    gs.stats().tilesDrawn++;
+                    continue;
+                }
+                releaseTile(it);            // 放缩比例略有不同
+            }
+
+            RECT_2D rc = { x, y, x + tsize, y + tsize };
+            Box2d rect(rc);
+            GiSaveClipBox clip(&gs, rect * xf.displayToWorld());
+
+            if (!clip.succeed())
+                continue;
+            count += drawer->drawTile(gs);
+            gs.stats().tilesRendered++;
+
+            if (!wnd.contains(rect))        // 只缓存完整显示的图块
+                continue;
+
+            int left = (int)floorf(x);
+            int top = (int)floorf(y);
+            int size = m_tilePixels + 1;
+            Tile tile;
+
+            tile.handle = canvas->saveTileBitmap(left, top, size, size);
+            if (!tile.handle) {
+                m_unsupported = true;
+                continue;
+            }
+            tile.key = key;
+            tile.scale = scale;
+            tile.fx = x - left;
+            tile.fy = y - top;
+            tile.bytes = 4L * size * size;
+            tile.rectW = rect * xf.displayToWorld();
+
+            m_tiles.push_front(tile);
+            m_map[key] = m_tiles.begin();
+            m_usedBytes += tile.bytes;
+        }
+    }
+    evict();
+
+    return count;
+}
@@ -10,5 +10,6 @@
 %include <gicontxt.h>
 %include <gixform.h>
 %include <gicanvdr.h>
+%include <gigraph.h>
 %include <gicanvas.h>
 %include <gipath.h>
@@ -2,6 +2,7 @@
 #include <mglnrel.h>
 #include <mgshapet.h>
 #include <mgbasicsp.h>
+#include <algorithm>
 
 float mgDisplayMmToModel(float mm, GiGraphics* gs);
 
@@ -47,12 +48,6 @@ void MgCommandBreak::gatherShapes(const MgMotion* sender, MgShapes* shapes)
     }
 }
 
-bool MgCommandBreak::touchBegan(const MgMotion*)
-{
-    _target = NULL;
-    return true;
-}
-
 static bool canBreak(MgBaseShape* sp)
 {
     return (sp->isKindOf(MgLine::Type())
@@ -62,53 +57,98 @@ static bool canBreak(MgBaseShape* sp)
             || sp->isKindOf(MgParallelogram::Type()));
 }
 
-bool MgCommandBreak::touchMoved(const MgMotion* sender)
+void MgCommandBreak::buildSegments(MgShapes* shapes)
 {
-    Box2d snapbox(sender->startPointM, sender->pointM);
+    std::vector<Point2d> pts;
     void* it = NULL;
-    Point2d crosspt;
     
-    _target = NULL;
-    _edges[0] = _edges[1] = -1;
+    _segShapes.clear();
+    _segEdges.clear();
+    _changeCount = shapes->getChangeCount();
     
-    for (MgShape* sp = sender->view->shapes()->getFirstShape(it);
-         sp; sp = sender->view->shapes()->getNextShape(it)) {
-        if (!sp->shape()->getExtent().isIntersect(snapbox)
-            || !canBreak(sp->shape())) {
+    for (MgShape* sp = shapes->getFirstShape(it); sp; sp = shapes->getNextShape(it)) {
+        if (!canBreak(sp->shape()))
             continue;
-        }
         
         UInt32 n = sp->shapec()->getPointCount();
         if (n == 4) {
             for (UInt32 i = 0; i < n; i++) {
-                Point2d pt1(sp->shapec()->getHandlePoint(i));
-                Point2d pt2(sp->shapec()->getHandlePoint((i + 1) % n));
-                
-                if (mgCross2Line(pt1, pt2, sender->startPointM, sender->pointM, crosspt))
-                {
-                    if (_target == sp) {
-                        _edges[1] = i;
-                        _crosspt[1] = crosspt;
-                    }
-                    else if (!_target || _edges[1] != (_edges[0] + 2) % 4) {
-                        _target = sp;
-                        _edges[0] = i;
-                        _crosspt[0] = crosspt;
-                        _edges[1] = -1;
-                    }
-                }
+                pts.push_back(sp->shapec()->getHandlePoint(i));
+                pts.push_back(sp->shapec()->getHandlePoint((i + 1) % n));
+                _segShapes.push_back(sp);
+                _segEdges.push_back(i);
             }
         }
-        else if (n == 2 && _edges[1] < 0) {
-            if (mgCross2Line(sp->shapec()->getPoint(0), 
-                             sp->shapec()->getPoint(1), 
-                             sender->startPointM, sender->pointM, crosspt)) {
+        else if (n == 2) {
+            pts.push_back(sp->shapec()->getPoint(0));
+            pts.push_back(sp->shapec()->getPoint(1));
+            _segShapes.push_back(sp);
+            _segEdges.push_back(0);
+        }
+    }
+    shapes->freeIterator(it);
+    
+    _grid.build((Int32)_segShapes.size(), pts.empty() ? NULL : &pts.front());
+}
+
+bool MgCommandBreak::touchBegan(const MgMotion* sender)
+{
+    _target = NULL;
+    buildSegments(sender->view->shapes());
+    return true;
+}
+
+typedef std::pair<Int32, Point2d> CrossSeg;
+
+static bool addCrossSeg(void* data, Int32 seg, Int32, const Point2d& pt)
+{
+    ((std::vector<CrossSeg>*)data)->push_back(CrossSeg(seg, pt));
+    return true;
+}
+
+static bool lessCrossSeg(const CrossSeg& a, const CrossSeg& b)
+{
+    return a.first < b.first;
+}
+
+bool MgCommandBreak::touchMoved(const MgMotion* sender)
+{
+    std::vector<CrossSeg> crosses;
+    
+    _target = NULL;
+    _edges[0] = _edges[1] = -1;
+    
+    if (_changeCount != sender->view->shapes()->getChangeCount()) {
+        buildSegments(sender->view->shapes());
+    }
+    
+    // 各边按图形顺序和边号排列，交点按边的序号排序后与逐个图形求交的结果一致
+    _grid.findCross(sender->startPointM, sender->pointM, addCrossSeg, &crosses);
+    std::sort(crosses.begin(), crosses.end(), lessCrossSeg);
+    
+    for (size_t j = 0; j < crosses.size(); j++) {
+        MgShape* sp = _segShapes[crosses[j].first];
+        int i = _segEdges[crosses[j].first];
+        const Point2d& crosspt = crosses[j].second;
+        
+        if (sp->shapec()->getPointCount() == 4) {
+            if (_target == sp) {
+                _edges[1] = i;
+                _crosspt[1] = crosspt;
+            }
+            else if (!_target || _edges[1] != (_edges[0] + 2) % 4) {
                 _target = sp;
+                _edges[0] = i;
                 _crosspt[0] = crosspt;
-                _edges[0] = 0;
                 _edges[1] = -1;
             }
         }
+        else if (_edges[1] < 0) {
+            _target = sp;
+            _crosspt[0] = crosspt;
+            _edges[0] = 0;
+            _edges[1] = -1;
+        }
     }
         
     sender->view->redraw(true);
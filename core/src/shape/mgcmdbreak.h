@@ -2,11 +2,13 @@
 #define __GEOMETRY_MGCOMMAND_BREAK_H_
 
 #include <mgcmd.h>
+#include <mgcross.h>
+#include <vector>
 
 class MgCommandBreak : MgBaseCommand
 {
 protected:
-    MgCommandBreak() {}
+    MgCommandBreak() : _target(NULL), _changeCount(0) {}
     virtual ~MgCommandBreak() {}
 
 public:
@@ -22,11 +24,17 @@ private:
     virtual bool touchMoved(const MgMotion* sender);
     virtual bool touchEnded(const MgMotion* sender);
     virtual bool isFloatingCommand() { return true; }
+    void buildSegments(MgShapes* shapes);
     
 private:
     MgShape*    _target;
     int         _edges[2];
     Point2d     _crosspt[2];
+    
+    MgCrossGrid _grid;                  // 可断开图形的各边，拖动时只需与拖动线求交
+    std::vector<MgShape*>   _segShapes; // 各边所在的图形
+    std::vector<int>        _segEdges;  // 各边在图形中的边号
+    UInt32      _changeCount;           // 生成 _grid 时图形列表的改变计数
 };
 
 #endif // __GEOMETRY_MGCOMMAND_BREAK_H_
@@ -111,7 +111,7 @@ bool MgCommandDraw::_click(const MgMotion* sender)
     Box2d limits(sender->pointM, mgDisplayMmToModel(10, sender), 0);
     Point2d nearpt;
     Int32 segment;
-    MgShape* shape = sender->view->shapes()->hitTest(limits, nearpt, segment);
+    MgShape* shape = mgHitTestShapes(sender, limits, nearpt, segment);
     
     if (shape) {
         g_newShapeID = shape->getID();
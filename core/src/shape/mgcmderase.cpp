@@ -10,6 +10,8 @@
 #include <mgaction.h>
 
 float mgDisplayMmToModel(float mm, const MgMotion* sender);
+MgShape* mgHitTestShapes(const MgMotion* sender, const Box2d& limits,
+                         Point2d& nearpt, Int32& segment);
 
 MgCommandErase::MgCommandErase()
 {
@@ -90,7 +92,7 @@ MgShape* MgCommandErase::hitTest(const MgMotion* sender)
     Point2d nearpt;
     Int32 segment;
     
-    return sender->view->shapes()->hitTest(limits, nearpt, segment);
+    return mgHitTestShapes(sender, limits, nearpt, segment);
 }
 
 bool MgCommandErase::click(const MgMotion* sender)
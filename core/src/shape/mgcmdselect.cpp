@@ -14,6 +14,8 @@
 #include <mgaction.h>
 
 extern UInt32 g_newShapeID;
+MgShape* mgHitTestShapes(const MgMotion* sender, const Box2d& limits,
+                         Point2d& nearpt, Int32& segment);
 
 UInt32 MgCommandSelect::getSelection(MgView* view, UInt32 count,
                                      MgShape** shapes, bool forChange)
@@ -333,7 +335,7 @@ MgShape* MgCommandSelect::hitTestAll(const MgMotion* sender,
                                      Point2d &nearpt, Int32 &segment)
 {
     Box2d limits(sender->pointM, mgDisplayMmToModel(10, sender), 0);
-    return sender->view->shapes()->hitTest(limits, nearpt, segment);
+    return mgHitTestShapes(sender, limits, nearpt, segment);
 }
 
 MgShape* MgCommandSelect::getSelectedShape(const MgMotion* sender)
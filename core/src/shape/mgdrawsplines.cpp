@@ -81,7 +81,10 @@ bool MgCmdDrawSplines::touchMoved(const MgMotion* sender)
             lines->addPoint(sender->pointM);
         }
     }
-    dynshape()->shape()->update();
+    if (m_freehand)                     // 只更新末尾几段，避免长笔画越画越慢
+        ((MgSplines*)lines)->updateTail();
+    else
+        dynshape()->shape()->update();
     
     return _touchMoved(sender);
 }
@@ -90,8 +93,8 @@ bool MgCmdDrawSplines::touchEnded(const MgMotion* sender)
 {
     if (m_freehand) {
         if (m_step > 1) {
-            //MgSplines* splines = (MgSplines*)dynshape()->shape();
-            //splines->smooth(mgLineHalfWidthModel(m_shape, sender) + mgDisplayMmToModel(1, sender));
+            MgSplines* splines = (MgSplines*)dynshape()->shape();
+            splines->fitKnots(mgLineHalfWidthModel(dynshape(), sender) + mgDisplayMmToModel(1, sender));
             _addshape(sender);
         }
         else {
@@ -70,27 +70,7 @@ bool MgEllipse::_setHandlePoint(UInt32 index, const Point2d& pt, float tol)
 float MgEllipse::_hitTest(const Point2d& pt, float tol, 
                           Point2d& nearpt, Int32& segment) const
 {
-    float distMin = _FLT_MAX;
-    const Box2d rect (pt, 2 * tol, 2 * tol);
-    Point2d ptTemp;
-
-    segment = -1;
-    for (int i = 0; i < 4; i++)
-    {
-        if (rect.isIntersect(Box2d(4, _bzpts + 3 * i)))
-        {
-            mgNearestOnBezier(pt, _bzpts + 3 * i, ptTemp);
-            float dist = pt.distanceTo(ptTemp);
-            if (dist <= tol && dist < distMin)
-            {
-                distMin = dist;
-                nearpt = ptTemp;
-                segment = i;
-            }
-        }
-    }
-
-    return distMin;
+    return mgNearestOnBeziers(pt, 4, _bzpts, 3, tol, nearpt, segment);
 }
 
 bool MgEllipse::_hitTestBox(const Box2d& rect) const
@@ -5,13 +5,20 @@
 #include "mgbasicsp.h"
 #include <mgshape_.h>
 #include <mgnear.h>
+#include <mgcurv.h>
+#include <mglnrel.h>
+#include <mgbatch.h>
 #include <mgstorage.h>
+#include <mgsegtree.h>
+#include <mgarclen.h>
+#include <gicontxt.h>
+#include <gidef.h>
 
 // MgBaseLines
 //
 
 MgBaseLines::MgBaseLines()
-    : _points(NULL), _maxCount(0), _count(0)
+    : _points(NULL), _maxCount(0), _count(0), _segtree(NULL), _arclen(NULL)
 {
 }
 
@@ -19,6 +26,7 @@ MgBaseLines::~MgBaseLines()
 {
     if (_points)
         delete[] _points;
+    _clearCaches();
 }
 
 UInt32 MgBaseLines::_getPointCount() const
@@ -33,8 +41,10 @@ Point2d MgBaseLines::_getPoint(UInt32 index) const
 
 void MgBaseLines::_setPoint(UInt32 index, const Point2d& pt)
 {
-    if (index < _count)
+    if (index < _count) {
         _points[index] = pt;
+        _clearCaches();
+    }
 }
 
 void MgBaseLines::_copy(const MgBaseLines& src)
@@ -42,6 +52,7 @@ void MgBaseLines::_copy(const MgBaseLines& src)
     resize(src._count);
     for (UInt32 i = 0; i < _count; i++)
         _points[i] = src._points[i];
+    _clearCaches();
 
     __super::_copy(src);
 }
@@ -68,6 +79,7 @@ bool MgBaseLines::_isKindOf(UInt32 type) const
 void MgBaseLines::_update()
 {
     _extent.set(_count, _points);
+    _clearCaches();
     __super::_update();
 }
 
@@ -75,12 +87,14 @@ void MgBaseLines::_transform(const Matrix2d& mat)
 {
     for (UInt32 i = 0; i < _count; i++)
         _points[i] *= mat;
+    _clearCaches();
     __super::_transform(mat);
 }
 
 void MgBaseLines::_clear()
 {
     _count = 0;
+    _clearCaches();
     __super::_clear();
 }
 
@@ -104,6 +118,7 @@ bool MgBaseLines::resize(UInt32 count)
         _points = pts;
     }
     _count = count;
+    _clearCaches();
     return true;
 }
 
@@ -123,6 +138,7 @@ bool MgBaseLines::insertPoint(Int32 segment, const Point2d& pt)
         for (Int32 i = (Int32)_count - 1; i > segment + 1; i--)
             _points[i] = _points[i - 1];
         _points[segment + 1] = pt;
+        _clearCaches();
         ret = true;
     }
     
@@ -138,6 +154,7 @@ bool MgBaseLines::removePoint(UInt32 index)
         for (UInt32 i = index + 1; i < _count; i++)
             _points[i - 1] = _points[i];
         _count--;
+        _clearCaches();
         ret = true;
     }
     
@@ -171,7 +188,54 @@ bool MgBaseLines::_setHandlePoint(UInt32 index, const Point2d& pt, float tol)
 float MgBaseLines::_hitTest(const Point2d& pt, float tol, 
                             Point2d& nearpt, Int32& segment) const
 {
-    return mgLinesHit(_count, _points, isClosed(), pt, tol, nearpt, segment);
+    const MgSegmentTree* tree = _getSegmentTree(NULL);
+    
+    if (!tree)
+        return mgLinesHit(_count, _points, isClosed(), pt, tol, nearpt, segment);
+    
+    std::vector<Int32> segs;
+    
+    if (isClosed()) {                           // 与 mgLinesHit 相同，先判断点与多边形的关系
+        float eps = Tol::gTol().equalPoint();   // 只需检查穿过竖直线的边
+        
+        tree->findSegments(Box2d(pt.x - eps, -_FLT_MAX, pt.x + eps, _FLT_MAX), segs);
+        switch (mgPtInAreaEdges(pt, _count, _points, (Int32)segs.size(),
+                                segs.empty() ? NULL : &segs.front(), segment)) {
+            case kMgPtOutArea:
+                return _FLT_MAX;
+            case kMgPtAtVertex:
+                nearpt = _points[segment];
+                return nearpt.distanceTo(pt);
+            case kMgPtOnEdge:
+                return mgPtToLine(_points[segment], _points[(segment + 1) % _count], pt, nearpt);
+            default:
+                break;
+        }
+        
+        // 在区内时竖直线必穿过边，其中最近的距离限定了查找范围，填充图形的容差很大时也不必遍历所有边
+        for (size_t j = 0; j < segs.size(); j++) {
+            Int32 i = segs[j];
+            tol = mgMin(tol, mgPtToLine(_points[i], _points[(i + 1) % _count], pt, nearpt));
+        }
+        segs.clear();
+    }
+    
+    Point2d ptTemp;
+    float dist, distMin = _FLT_MAX;
+    
+    tree->findSegments(Box2d(pt, 2 * tol, 2 * tol), segs);
+    for (size_t j = 0; j < segs.size(); j++) {
+        Int32 i = segs[j];
+        
+        dist = mgPtToLine(_points[i], _points[(i + 1) % _count], pt, ptTemp);
+        if (dist <= tol && dist < distMin) {
+            distMin = dist;
+            nearpt = ptTemp;
+            segment = i;
+        }
+    }
+    
+    return distMin;
 }
 
 bool MgBaseLines::_hitTestBox(const Box2d& rect) const
@@ -179,6 +243,11 @@ bool MgBaseLines::_hitTestBox(const Box2d& rect) const
     if (!__super::_hitTestBox(rect))
         return false;
     
+    const MgSegmentTree* tree = _getSegmentTree(NULL);
+    
+    if (tree)
+        return tree->isIntersect(rect);
+    
     for (UInt32 i = 0; i + 1 < _count; i++) {
         if (Box2d(_points[i], _points[i + 1]).isIntersect(rect))
             return true;
@@ -187,6 +256,126 @@ bool MgBaseLines::_hitTestBox(const Box2d& rect) const
     return _count < 2;
 }
 
+const MgSegmentTree* MgBaseLines::_getSegmentTree(const Vector2d* knotvs) const
+{
+    Int32 n = (Int32)_count - (isClosed() ? 0 : 1);     // 段数
+    
+    if (n < MIN_TREE_SEGMENTS)
+        return NULL;
+    
+    // 显示时多个线程可能同时生成，生成完后原子地设置，已被其他线程设置时放弃本线程的结果
+    MgSegmentTree* tree = (MgSegmentTree*)giInterlockedReadPtr((void* volatile*)&_segtree);
+    
+    if (!tree) {
+        Box2d* boxes = new Box2d[n];
+        Point2d pts[4];
+        
+        if (knotvs) {
+            for (Int32 i = 0; i < n; i++) {     // 曲线段在其控制点的凸包内
+                mgCubicSplineToBezier(_count, _points, knotvs, i, pts);
+                boxes[i].set(4, pts);
+            }
+        }
+        else {
+            mgLineBoxes(_count, _points, boxes);
+            if (isClosed())                     // 闭合折线的末段
+                boxes[n - 1].set(_points[n - 1], _points[0]);
+            for (Int32 i = 0; i < n; i++) {     // 与 Box2d(pt1, pt2) 一样扩大水平段和竖直段的框
+                if (boxes[i].isEmpty())
+                    boxes[i].inflate(Tol::gTol().equalPoint());
+            }
+        }
+        
+        tree = new MgSegmentTree();
+        tree->build(n, boxes);
+        delete[] boxes;
+        
+        if (!giInterlockedCasPtr((void* volatile*)&_segtree, NULL, tree)) {
+            delete tree;
+            tree = (MgSegmentTree*)giInterlockedReadPtr((void* volatile*)&_segtree);
+        }
+    }
+    
+    return tree;
+}
+
+const MgArcLength* MgBaseLines::_getArcLength(const Vector2d* knotvs) const
+{
+    // 与 _getSegmentTree 一样，生成完后原子地设置，已被其他线程设置时放弃本线程的结果
+    MgArcLength* arclen = (MgArcLength*)giInterlockedReadPtr((void* volatile*)&_arclen);
+    
+    if (!arclen) {
+        arclen = new MgArcLength();
+        
+        if (knotvs && _count > 1) {
+            Int32 n = (Int32)_count - (isClosed() ? 0 : 1);     // 段数
+            Point2d* pts = new Point2d[3 * n + 1];
+            
+            for (Int32 i = 0; i < n; i++) {     // 相邻段共用端点
+                mgCubicSplineToBezier(_count, _points, knotvs, i, pts + 3 * i);
+            }
+            
+            Box2d box(3 * n + 1, pts);
+            arclen->buildBeziers(3 * n + 1, pts, mgMax(box.width(), box.height()) * 1e-4f);
+            delete[] pts;
+        }
+        else {
+            arclen->buildLines(_count, _points, isClosed());
+        }
+        if (!giInterlockedCasPtr((void* volatile*)&_arclen, NULL, arclen)) {
+            delete arclen;
+            arclen = (MgArcLength*)giInterlockedReadPtr((void* volatile*)&_arclen);
+        }
+    }
+    
+    return arclen;
+}
+
+void MgBaseLines::_clearCaches()
+{
+    if (_segtree) {
+        delete _segtree;
+        _segtree = NULL;
+    }
+    if (_arclen) {
+        delete _arclen;
+        _arclen = NULL;
+    }
+}
+
+bool MgBaseLines::_findVisibleRuns(GiGraphics& gs, const GiContext& ctx,
+                                   const Vector2d* knotvs, std::vector<Int32>& runs) const
+{
+    if (isClosed() || ctx.getLineStyle() != kGiLineSolid)
+        return false;                           // 分开显示会改变填充区域或虚线的起始位置
+    
+    const MgSegmentTree* tree = _getSegmentTree(knotvs);
+    
+    if (!tree)
+        return false;
+    
+    // 线条宽度和转折处的尖角可能超出段的绑定框
+    float width = gs.calcPenWidth(ctx.getLineWidth(), ctx.isAutoScale());
+    Box2d clip(gs.getClipModel());
+    std::vector<Int32> segs;
+    
+    clip.inflate(gs.xf().displayToModel(width * 6 + 2));
+    if (tree->findSegments(clip, segs) == tree->getCount())
+        return false;                           // 全部可见
+    
+    runs.clear();
+    for (size_t i = 0; i < segs.size(); i++) {
+        if (i > 0 && segs[i] == runs.back() + 1)
+            runs.back() = segs[i];
+        else {
+            runs.push_back(segs[i]);
+            runs.push_back(segs[i]);
+        }
+    }
+    
+    return true;
+}
+
 bool MgBaseLines::_save(MgStorage* s) const
 {
     bool ret = __super::_save(s);
@@ -225,8 +414,15 @@ MgLines::~MgLines()
 bool MgLines::_draw(GiGraphics& gs, const GiContext& ctx) const
 {
     bool ret = false;
+    std::vector<Int32> runs;
+    
     if (isClosed())
         ret = gs.drawPolygon(&ctx, _count, _points);
+    else if (_findVisibleRuns(gs, ctx, NULL, runs)) {
+        for (size_t i = 0; i < runs.size(); i += 2) {
+            ret = gs.drawLines(&ctx, runs[i + 1] - runs[i] + 2, _points + runs[i]) || ret;
+        }
+    }
     else
         ret = gs.drawLines(&ctx, _count, _points);
     return __super::_draw(gs, ctx) || ret;
@@ -0,0 +1,123 @@
+// mglod.cpp: 实现微小图形的简化显示辅助类 MgLodDrawer
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+
+#include "mglod.h"
+#include <gicontxt.h>
+#include <algorithm>
+
+MgLodDrawer::MgLodDrawer(GiGraphics& gs)
+    : _gs(gs), _mode(gs.getLodMode()), _threshold(gs.getLodThreshold())
+    , _cellSize(gs.getLodCellSize()), _cols(0), _rows(0), _count(0)
+{
+    if (_threshold < _MGZERO)
+        _mode = kGiLodNone;
+}
+
+bool MgLodDrawer::drawTiny(const MgShape* shape, const GiContext* ctx)
+{
+    if (kGiLodNone == _mode)
+        return false;
+    
+    Box2d rect(shape->shapec()->getExtent() * _gs.xf().modelToDisplay());
+    
+    if (mgMax(rect.width(), rect.height()) >= _threshold) {
+        if (!_used.empty())             // 先显示下面的微小图形
+            flush();
+        return false;
+    }
+    
+    GiColor color(shape->contextc()->getLineColor());
+    
+    if (ctx && ctx->getLineColor().a > 0)
+        color = ctx->getLineColor();
+    if (color.isInvalid() || shape->contextc()->isNullLine())
+        color = shape->contextc()->getFillColor();
+    _gs.stats().lodShapes++;
+    if (color.isInvalid())              // 不可见
+        return true;
+    
+    Point2d cen(rect.center());
+    float w = mgMax(rect.width(), 1.f);
+    float h = mgMax(rect.height(), 1.f);
+    
+    if (kGiLodSimple == _mode) {
+        GiContext fillctx(0, GiColor::Invalid(), kGiLineNull, color);
+        _gs.rawRect(&fillctx, cen.x - w / 2, cen.y - h / 2, w, h);
+        return true;
+    }
+    
+    if (_cells.empty()) {
+        _cols = (int)ceilf(_gs.xf().getWidth() / _cellSize);
+        _rows = (int)ceilf(_gs.xf().getHeight() / _cellSize);
+        if (_cols < 1 || _rows < 1)
+            return true;
+        
+        Cell cell = { 1.f, 0, 0, 0, 0 };
+        _cells.assign(_cols * _rows, cell);
+    }
+    
+    int col = (int)floorf(cen.x / _cellSize);
+    int row = (int)floorf(cen.y / _cellSize);
+    
+    if (col >= 0 && col < _cols && row >= 0 && row < _rows) {
+        Cell& cell = _cells[row * _cols + col];
+        
+        if (cell.clear == 1.f && cell.weight == 0)
+            _used.push_back(row * _cols + col);
+        
+        float cover = mgMin(1.f, w * h / (_cellSize * _cellSize)) * color.a / 255.f;
+        
+        cell.clear *= 1.f - cover;      // 各图形按独立覆盖累积不透明度
+        cell.r += color.r * cover;
+        cell.g += color.g * cover;
+        cell.b += color.b * cover;
+        cell.weight += cover;
+    }
+    
+    return true;
+}
+
+int MgLodDrawer::flush()
+{
+    const Cell empty = { 1.f, 0, 0, 0, 0 };
+    int count = 0;
+    
+    std::sort(_used.begin(), _used.end());      // 按行显示
+    for (size_t i = 0; i < _used.size(); i++) {
+        Cell& cell = _cells[_used[i]];
+        
+        if (cell.weight > _MGZERO) {
+            GiColor color((UInt8)(cell.r / cell.weight), 
+                          (UInt8)(cell.g / cell.weight), 
+                          (UInt8)(cell.b / cell.weight), 
+                          (UInt8)(255.f * (1.f - cell.clear) + 0.5f));
+            GiContext fillctx(0, GiColor::Invalid(), kGiLineNull, color);
+            int row = _used[i] / _cols;
+            int col = _used[i] % _cols;
+            
+            if (color.a > 0
+                && _gs.rawRect(&fillctx, col * _cellSize, row * _cellSize, 
+                               _cellSize, _cellSize)) {
+                count++;
+            }
+        }
+        cell = empty;
+    }
+    _used.clear();
+    _count += count;
+    _gs.stats().lodCells += count;
+    
+    return count;
+}
+
+int MgLodDrawer::end()
+{
+    flush();
+    _cells.clear();
+    
+    int count = _count;
+    _count = 0;
+    
+    return count;
+}
@@ -0,0 +1,150 @@
+// mgocclude.cpp: 实现被遮挡图形的剔除辅助类 MgOcclusionCuller
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+
+#include "mgocclude.h"
+#include <mgbasicsp.h>
+#include <gicontxt.h>
+
+MgOcclusionCuller::MgOcclusionCuller(GiGraphics& gs, const GiContext* ctx)
+    : _gs(gs), _ctx(ctx), _enabled(gs.isOcclusionCulling())
+    , _x0(0), _y0(0), _cols(0), _rows(0)
+{
+}
+
+int MgOcclusionCuller::cull()
+{
+    const int count = (int)_shapes.size();
+    std::vector<char> hidden(count, 0);
+    RECT_2D rc;
+    Box2d clip(_gs.getClipBox(rc), true);
+    int occluders = 0;
+
+    _x0 = clip.xmin;
+    _y0 = clip.ymin;
+    _cols = mgMax((int)ceilf(clip.width() / CELL), 0);
+    _rows = mgMax((int)ceilf(clip.height() / CELL), 0);
+    _cells.assign(_cols * _rows, 0);
+
+    // 后面的图形显示在上面，从末尾往前检查，被遮住的图形不再作为遮挡图形
+    for (int i = count - 1; i >= 0; i--) {
+        const MgShape* shape = _shapes[i];
+        Box2d inner;
+
+        if (occluders > 0 && isCovered(getDrawRect(shape))) {
+            hidden[i] = 1;
+        }
+        else if (getOccluder(shape, inner)) {
+            cover(inner);
+            occluders++;
+        }
+    }
+
+    _order.clear();
+    for (int i = 0; i < count; i++) {
+        if (!hidden[i])
+            _order.push_back(i);
+    }
+    _gs.stats().shapesOccluded += count - (int)_order.size();
+
+    return (int)_order.size();
+}
+
+bool MgOcclusionCuller::getOccluder(const MgShape* shape, Box2d& inner) const
+{
+    const MgBaseShape* sp = shape->shapec();
+    const Matrix2d& mat = _gs.xf().modelToDisplay();
+    GiColor color(shape->contextc()->getFillColor());
+
+    if (_ctx && _ctx->hasFillColor())
+        color = _ctx->getFillColor();
+    if (color.isInvalid() || color.a < 255 || !sp->isClosed()
+        || !sp->isKindOf(MgBaseRect::Type())
+        || !mgIsZero(mat.m12) || !mgIsZero(mat.m21)) {
+        return false;
+    }
+
+    const MgBaseRect* rect = (const MgBaseRect*)sp;
+
+    if (!rect->isOrtho())
+        return false;
+
+    const float k = 0.70710678f;    // 内接矩形与椭圆外框的尺寸比
+    Point2d cen(rect->getCenter());
+    float w = rect->getWidth();
+    float h = rect->getHeight();
+    UInt32 type = sp->getType();
+
+    if (type == MgRect::Type()) {
+        inner.set(cen, w, h);
+    }
+    else if (type == MgEllipse::Type()) {
+        inner.set(cen, w * k, h * k);
+    }
+    else if (type == MgRoundRect::Type()) {
+        const MgRoundRect* rr = (const MgRoundRect*)sp;
+        inner.set(cen, w - 2 * rr->getRadiusX() * (1 - k),
+                  h - 2 * rr->getRadiusY() * (1 - k));
+    }
+    else if (type == MgDiamond::Type()) {
+        inner.set(cen, w / 2, h / 2);
+    }
+    else {
+        return false;
+    }
+    if (inner.width() < _MGZERO || inner.height() < _MGZERO)
+        return false;
+
+    inner = inner * mat;
+    inner.deflate(1);               // 边缘像素是反走样的，不算遮住
+
+    return !inner.isEmpty();
+}
+
+Box2d MgOcclusionCuller::getDrawRect(const MgShape* shape) const
+{
+    const GiContext* ctx = shape->contextc();
+    float width = _gs.calcPenWidth(ctx->getLineWidth(), ctx->isAutoScale());
+
+    if (_ctx && !_ctx->isNullLine())    // 附加显示参数可能加宽线条
+        width += _gs.calcPenWidth(_ctx->getLineWidth(), _ctx->isAutoScale());
+
+    Box2d rect(shape->shapec()->getExtent() * _gs.xf().modelToDisplay());
+
+    return rect.inflate(width / 2 + 1);
+}
+
+bool MgOcclusionCuller::isCovered(const Box2d& rect) const
+{
+    int c0 = mgMax((int)floorf((rect.xmin - _x0) / CELL), 0);
+    int c1 = mgMin((int)floorf((rect.xmax - _x0) / CELL), _cols - 1);
+    int r0 = mgMax((int)floorf((rect.ymin - _y0) / CELL), 0);
+    int r1 = mgMin((int)floorf((rect.ymax - _y0) / CELL), _rows - 1);
+
+    if (c0 > c1 || r0 > r1)
+        return false;
+
+    for (int row = r0; row <= r1; row++) {
+        const char* cells = &_cells[row * _cols];
+        for (int col = c0; col <= c1; col++) {
+            if (!cells[col])
+                return false;
+        }
+    }
+
+    return true;
+}
+
+void MgOcclusionCuller::cover(const Box2d& rect)
+{
+    int c0 = mgMax((int)ceilf((rect.xmin - _x0) / CELL), 0);
+    int c1 = mgMin((int)floorf((rect.xmax - _x0) / CELL) - 1, _cols - 1);
+    int r0 = mgMax((int)ceilf((rect.ymin - _y0) / CELL), 0);
+    int r1 = mgMin((int)floorf((rect.ymax - _y0) / CELL) - 1, _rows - 1);
+
+    for (int row = r0; row <= r1; row++) {
+        char* cells = &_cells[row * _cols];
+        for (int col = c0; col <= c1; col++)
+            cells[col] = 1;
+    }
+}
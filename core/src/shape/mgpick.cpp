@@ -0,0 +1,218 @@
+// mgpick.cpp: 实现按图形ID位图点选图形的缓冲类 MgPickBuffer
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+
+#include "mgpick.h"
+#include <mgcmd.h>
+#include <gicontxt.h>
+#include <algorithm>
+
+static inline bool hasFillColor(const MgShape* shape)
+{
+    return shape->contextc()->hasFillColor() && shape->shapec()->isClosed();
+}
+
+MgPickBuffer::MgPickBuffer()
+    : _valid(false), _changeCount(0), _width(0), _height(0), _stamp(0)
+{
+    _canvas.setBkColor(GiColor(0, 0, 0, 0));
+    _canvas.gs().setAntiAliasMode(false);   // 只看是否覆盖，不需要混合边缘
+    _canvas.setFlatness(0.5f);              // 线条已加宽一格，曲线离散误差可放大
+}
+
+bool MgPickBuffer::isValid(MgShapes* shapes, const GiTransform& xf) const
+{
+    return _valid && shapes && _changeCount == shapes->getChangeCount()
+        && _m2d == xf.modelToDisplay()
+        && _width == xf.getWidth() && _height == xf.getHeight();
+}
+
+bool MgPickBuffer::update(MgShapes* shapes, const GiTransform& xf)
+{
+    if (!shapes)
+        return false;
+    if (!isValid(shapes, xf)) {
+        _changeCount = shapes->getChangeCount();
+        _m2d = xf.modelToDisplay();
+        _width = xf.getWidth();
+        _height = xf.getHeight();
+        _valid = render(shapes, xf);
+    }
+    return _valid;
+}
+
+void MgPickBuffer::addCell(int cell, Int32 index)
+{
+    _nexts.push_back(_heads[cell]);
+    _cellShapes.push_back(index);
+    _heads[cell] = (Int32)_cellShapes.size() - 1;
+}
+
+bool MgPickBuffer::collectCells(Int32 index, int x1, int y1, int x2, int y2)
+{
+    const int w = _canvas.getWidth();
+    unsigned char* pixels = _canvas.getPixels();
+    bool found = false;
+
+    for (int y = y1; y <= y2; y++) {
+        for (int x = x1; x <= x2; x++) {
+            unsigned char* p = pixels + ((size_t)y * w + x) * 4;
+
+            if (p[3]) {                     // 记下后清除，位图留给下一个图形
+                p[0] = p[1] = p[2] = p[3] = 0;
+                addCell(y * w + x, index);
+                found = true;
+            }
+        }
+    }
+
+    return found;
+}
+
+bool MgPickBuffer::render(MgShapes* shapes, const GiTransform& xf)
+{
+    const int w = (int)xf.getWidth() / CELL_PIXELS + 2;
+    const int h = (int)xf.getHeight() / CELL_PIXELS + 2;
+
+    _cellxf.copy(xf);                       // 中心和显示比例不变，一个像素对应一格
+    _cellxf.setWndSize(w, h);
+    _cellxf.setResolution(xf.getDpiX() / CELL_PIXELS, xf.getDpiY() / CELL_PIXELS);
+
+    if (!_canvas.beginPaint(_cellxf, 0, 0, w, h, true))
+        return false;
+
+    GiGraphics& gs = _canvas.gs();
+    const Matrix2d& m2d = _cellxf.modelToDisplay();
+    const GiColor color(0, 0, 0, 255);
+    GiContext ctx(-2, color, kGiLineSolid);     // 两边各加宽一格，经过格子任意一处的线条都算
+    GiContext fillctx(-2, color, kGiLineSolid, color);
+    GiContext dotctx(0, GiColor::Invalid(), kGiLineNull, color);
+    Box2d clip(gs.getClipModel());
+    void* it = NULL;
+
+    _heads.assign((size_t)w * h, -1);
+    _nexts.clear();
+    _cellShapes.clear();
+    _shapes.clear();
+
+    for (MgShape* shape = shapes->getFirstShape(it); shape; shape = shapes->getNextShape(it)) {
+        const MgBaseShape* sp = shape->shapec();
+        const GiContext* src = shape->contextc();
+        float r = gs.calcPenWidth(src->getLineWidth(), src->isAutoScale()) / 2 + 1;
+
+        if (!sp->getExtent().isIntersect(clip))
+            continue;
+        
+        const Int32 index = (Int32)_shapes.size();
+        _shapes.push_back(shape);
+
+        shape->draw(gs, hasFillColor(shape) ? &fillctx : &ctx);     // 实线，加宽一格
+
+        UInt32 n = sp->getPointCount();
+        if (!sp->isClosed() && n > 0) {     // 线条端点是平头的，补上圆头，与 hitTest 一致
+            gs.drawEllipse(&dotctx, sp->getPoint(0), _cellxf.displayToModel(r));
+            gs.drawEllipse(&dotctx, sp->getPoint(n - 1), _cellxf.displayToModel(r));
+        }
+
+        Box2d rect(sp->getExtent() * m2d);
+        rect.inflate(r + 1);
+        int x1 = mgMax(0, (int)floorf(rect.xmin));
+        int y1 = mgMax(0, (int)floorf(rect.ymin));
+        int x2 = mgMin(w - 1, (int)ceilf(rect.xmax));
+        int y2 = mgMin(h - 1, (int)ceilf(rect.ymax));
+
+        // 没有画出像素的微小图形按其范围记录，保证不漏掉能点中的图形
+        if (x1 <= x2 && y1 <= y2 && !collectCells(index, x1, y1, x2, y2)) {
+            for (int y = y1; y <= y2; y++) {
+                for (int x = x1; x <= x2; x++) {
+                    addCell(y * w + x, index);
+                }
+            }
+        }
+    }
+    shapes->freeIterator(it);
+    _canvas.endPaint();
+    _marks.assign(_shapes.size(), 0);
+    _stamp = 0;
+
+    return true;
+}
+
+MgShape* MgPickBuffer::hitTest(MgShapes* shapes, const GiTransform& xf, const Box2d& limits,
+                               Point2d& nearpt, Int32& segment)
+{
+    if (!shapes)
+        return NULL;
+
+    // MgShapes::hitTest 接受距离在点击范围宽度内的线条，最近点所在的格子必定在查看范围内
+    Point2d pt(limits.center() * _cellxf.modelToDisplay());
+    float radius = limits.width() / xf.displayToModel(1);
+    int rings = (int)ceilf(radius / CELL_PIXELS) + 1;
+    int cx = (int)floorf(pt.x);
+    int cy = (int)floorf(pt.y);
+    int w = _canvas.getWidth();
+
+    // 修改图形时记录的图形可能已删除，改变计数要到修改完才增加
+    if (!isValid(shapes, xf) || shapes->getLockData()->lockedForWrite()
+        || cx - rings < 0 || cy - rings < 0
+        || cx + rings >= w || cy + rings >= _canvas.getHeight()) {
+        return shapes->hitTest(limits, nearpt, segment);
+    }
+
+    if (++_stamp == 0) {                    // 计数用完后重新开始
+        _marks.assign(_shapes.size(), 0);
+        _stamp = 1;
+    }
+    _found.clear();
+    for (int y = cy - rings; y <= cy + rings; y++) {
+        for (int x = cx - rings; x <= cx + rings; x++) {
+            for (Int32 i = _heads[y * w + x]; i >= 0; i = _nexts[i]) {
+                if (_marks[_cellShapes[i]] != _stamp) {
+                    _marks[_cellShapes[i]] = _stamp;
+                    _found.push_back(_cellShapes[i]);
+                }
+            }
+        }
+    }
+    std::sort(_found.begin(), _found.end());    // 按显示次序，距离相同时与遍历的结果一致
+
+    MgShape* retshape = NULL;
+    float distMin = _FLT_MAX;
+
+    for (size_t i = 0; i < _found.size(); i++) {
+        MgShape* shape = _shapes[_found[i]];
+        if (!shape->shapec()->getExtent().isIntersect(limits))
+            continue;
+
+        Box2d extent(shape->shapec()->getExtent());
+        Point2d tmpNear;
+        Int32   tmpSegment;
+        float   tol = (!hasFillColor(shape) ? limits.width() / 2
+                       : mgMax(extent.width(), extent.height()));
+        float   dist = shape->shapec()->hitTest(limits.center(), tol, tmpNear, tmpSegment);
+
+        if (distMin > dist) {
+            distMin = dist;
+            segment = tmpSegment;
+            nearpt = tmpNear;
+            retshape = shape;
+        }
+    }
+    if (retshape && distMin > limits.width() && !hasFillColor(retshape)) {
+        retshape = NULL;
+    }
+
+    return retshape;
+}
+
+MgShape* mgHitTestShapes(const MgMotion* sender, const Box2d& limits,
+                         Point2d& nearpt, Int32& segment)
+{
+    MgPickBuffer* picker = sender->view->pickBuffer();
+    MgShapes* shapes = sender->view->shapes();
+
+    if (picker)
+        return picker->hitTest(shapes, *sender->view->xform(), limits, nearpt, segment);
+
+    return shapes->hitTest(limits, nearpt, segment);
+}
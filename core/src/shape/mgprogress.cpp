@@ -0,0 +1,104 @@
+// mgprogress.cpp: 实现分步显示图形列表的进度类 MgDrawProgress
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+
+#include "mgprogress.h"
+#include <algorithm>
+
+MgDrawProgress::MgDrawProgress(float budgetMs, long budgetPrims)
+    : _budgetMs(budgetMs), _budgetPrims(budgetPrims), _largeFirst(false)
+    , _started(false), _collected(false), _shapesCount(0)
+    , _pos(0), _changeCount(0), _zoomTimes(0)
+    , _gs(NULL), _tick(0), _prims(0), _drawn(0)
+{
+}
+
+void MgDrawProgress::setBudget(float ms, long primitives)
+{
+    _budgetMs = mgMax(ms, 0.f);
+    _budgetPrims = mgMax(primitives, 0L);
+}
+
+void MgDrawProgress::restart()
+{
+    _started = false;
+    _collected = false;
+    _pos = 0;
+    _order.clear();
+}
+
+bool MgDrawProgress::begin(GiGraphics& gs, UInt32 changeCount)
+{
+    const int count = (int)_shapes.size();
+
+    if (_started && (_changeCount != changeCount
+                     || _zoomTimes != gs.xf().getZoomTimes()
+                     || _clip != gs.getClipModel())) {
+        restart();
+    }
+    if (!_started) {
+        _started = true;
+        _changeCount = changeCount;
+        _zoomTimes = gs.xf().getZoomTimes();
+        _clip = gs.getClipModel();
+
+        const Matrix2d& mat = gs.xf().modelToDisplay();
+        Item item;
+
+        _order.reserve(count);
+        for (int i = 0; i < count; i++) {
+            Box2d rect(_shapes[i]->shapec()->getExtent());
+            if (rect.isIntersect(_clip)) {
+                rect = rect * mat;
+                item.index = i;
+                item.id = _shapes[i]->getID();
+                item.size = mgMax(rect.width(), rect.height());
+                _order.push_back(item);
+            }
+        }
+        if (_largeFirst)
+            std::stable_sort(_order.begin(), _order.end());
+
+        gs.stats().shapesVisited += count;
+        gs.stats().shapesCulled += count - (int)_order.size();
+    }
+
+    _gs = &gs;
+    _tick = GiDrawStats::tickMs();
+    _prims = gs.stats().primitives();
+    _drawn = 0;
+
+    return _pos < (int)_order.size();
+}
+
+const MgShape* MgDrawProgress::next()
+{
+    if (_pos >= (int)_order.size())
+        return NULL;
+    if (_drawn > 0) {       // 至少显示一个图形，避免预算过小时没有进展
+        if (_budgetMs > 0 && GiDrawStats::tickMs() - _tick >= _budgetMs)
+            return NULL;
+        if (_budgetPrims > 0 && _gs->stats().primitives() - _prims >= _budgetPrims)
+            return NULL;
+    }
+
+    const Item& item = _order[_pos];
+
+    if (item.index >= (int)_shapes.size() || _shapes[item.index]->getID() != item.id) {
+        _changeCount = (UInt32)-1;  // 图形列表已改变，下次重新收集并从头显示
+        _collected = false;
+        return NULL;
+    }
+    _pos++;
+    _drawn++;
+
+    return _shapes[item.index];
+}
+
+void MgDrawProgress::end()
+{
+    if (_gs) {
+        _gs->stats().shapesMs += (float)(GiDrawStats::tickMs() - _tick);
+        _gs = NULL;
+    }
+}
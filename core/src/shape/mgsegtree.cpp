@@ -0,0 +1,72 @@
+// mgsegtree.cpp: 实现折线和曲线各段的绑定框层次类 MgSegmentTree
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+
+#include "mgsegtree.h"
+
+void MgSegmentTree::build(Int32 count, const Box2d* boxes)
+{
+    _boxes.assign(boxes, boxes + mgMax(count, (Int32)0));
+    _levels.clear();
+    if (count < 1)
+        return;
+
+    _levels.push_back(0);
+    for (Int32 first = 0, n = count; ; n = (n + FANOUT - 1) / FANOUT) {
+        _levels.push_back(first + n);
+        if (n == 1)
+            break;
+
+        // 不用 Box2d::unionWith，因为水平段或垂直段的框宽或高为零，会被当作空框忽略
+        for (Int32 i = 0; i < n; i += FANOUT) {
+            Box2d box(_boxes[first + i]);
+
+            for (Int32 j = i + 1; j < n && j < i + FANOUT; j++) {
+                const Box2d& child = _boxes[first + j];
+                box.xmin = mgMin(box.xmin, child.xmin);
+                box.ymin = mgMin(box.ymin, child.ymin);
+                box.xmax = mgMax(box.xmax, child.xmax);
+                box.ymax = mgMax(box.ymax, child.ymax);
+            }
+            _boxes.push_back(box);
+        }
+        first += n;
+    }
+}
+
+bool MgSegmentTree::isIntersect(const Box2d& rect) const
+{
+    return !_levels.empty() && find(rect, (Int32)_levels.size() - 2, 0, NULL);
+}
+
+Int32 MgSegmentTree::findSegments(const Box2d& rect, std::vector<Int32>& segments) const
+{
+    size_t n = segments.size();
+
+    if (!_levels.empty())
+        find(rect, (Int32)_levels.size() - 2, 0, &segments);
+
+    return (Int32)(segments.size() - n);
+}
+
+bool MgSegmentTree::find(const Box2d& rect, Int32 level, Int32 first,
+                         std::vector<Int32>* segments) const
+{
+    Int32 last = mgMin(first + FANOUT, _levels[level + 1] - _levels[level]);
+    const Box2d* boxes = &_boxes[_levels[level]];
+
+    for (Int32 i = first; i < last; i++) {
+        if (!boxes[i].isIntersect(rect))
+            continue;
+        if (level == 0) {
+            if (!segments)
+                return true;
+            segments->push_back(i);
+        }
+        else if (find(rect, level - 1, i * FANOUT, segments) && !segments) {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,77 @@
+// mgsorter.cpp: 实现按显示参数排序显示的辅助类 MgStyleSorter
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+
+#include "mgsorter.h"
+#include <gicontxt.h>
+
+MgStyleSorter::MgStyleSorter(GiGraphics& gs)
+    : _gs(gs), _enabled(gs.isStyleSorting())
+{
+}
+
+void MgStyleSorter::add(const MgShape* shape)
+{
+    const GiContext* ctx = shape->contextc();
+    Item item;
+    
+    item.shape = shape;
+    item.rect = shape->shapec()->getExtent() * _gs.xf().modelToDisplay();
+    item.rect.inflate(_gs.calcPenWidth(ctx->getLineWidth(), ctx->isAutoScale()) / 2 + 1);
+    item.next = -1;
+    _items.push_back(item);
+}
+
+int MgStyleSorter::sort()
+{
+    const int count = (int)_items.size();
+    int before = 0;
+    
+    _batches.clear();
+    _order.clear();
+    
+    for (int i = 0; i < count; i++) {
+        Item& item = _items[i];
+        const GiContext* ctx = item.shape->contextc();
+        int target = -1;
+        
+        if (i > 0 && !_items[i - 1].shape->contextc()->equals(*ctx))
+            before++;
+        
+        // 从最后一个批次向前找参数相同的批次，遇到重叠的其他批次则停止
+        for (int b = (int)_batches.size() - 1, k = 0; b >= 0 && k < LOOKBACK; b--, k++) {
+            if (_batches[b].ctx->equals(*ctx)) {
+                target = b;
+                break;
+            }
+            if (_batches[b].rect.isIntersect(item.rect))
+                break;
+        }
+        
+        if (target < 0) {
+            Batch batch;
+            batch.ctx = ctx;
+            batch.rect = item.rect;
+            batch.first = batch.last = i;
+            _batches.push_back(batch);
+        }
+        else {
+            Batch& batch = _batches[target];
+            batch.rect.unionWith(item.rect);
+            _items[batch.last].next = i;
+            batch.last = i;
+        }
+    }
+    
+    for (int b = 0; b < (int)_batches.size(); b++) {
+        for (int i = _batches[b].first; i >= 0; i = _items[i].next)
+            _order.push_back(i);
+    }
+    
+    int after = mgMax((int)_batches.size() - 1, 0);
+    
+    _gs.stats().styleChanges += after;
+    _gs.stats().styleChangesSaved += before - after;
+    
+    return count;
+}
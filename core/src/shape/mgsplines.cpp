@@ -6,10 +6,12 @@
 #include <mgshape_.h>
 #include <mgnear.h>
 #include <mgcurv.h>
+#include <mgsegtree.h>
+#include <mgarclen.h>
 
 MG_IMPLEMENT_CREATE(MgSplines)
 
-MgSplines::MgSplines() : _knotvs(NULL), _bzcount(0)
+MgSplines::MgSplines() : _knotvs(NULL), _bzcount(0), _solved(0), _frozen(0)
 {
 }
 
@@ -33,30 +35,122 @@ void MgSplines::_update()
 
     mgCubicSplines(_count, _points, _knotvs, isClosed() ? kMgCubicLoop : 0);
     mgCubicSplinesBox(_extent, _count, _points, _knotvs);
+
+    _solved = _count;
+    _frozen = 0;
+    _frozenBox.empty();
+}
+
+void MgSplines::updateTail()
+{
+    UInt32 n = _count;
+    UInt32 start = n - TAIL;                        // 窗口起点，其切矢量不变
+
+    if (_solved > 1 && start >= _solved)            // 一次添加了多个点
+        start = _solved - 1;
+    if (isClosed() || n <= TAIL || _solved < 2 || _solved > n || _frozen > start) {
+        update();
+        return;
+    }
+    if (_bzcount < n) {                             // 扩大数组时保留已算出的切矢量
+        Vector2d* knotvs = new Vector2d[_maxCount];
+        for (UInt32 i = 0; i < _solved; i++)
+            knotvs[i] = _knotvs[i];
+        delete[] _knotvs;
+        _knotvs = knotvs;
+        _bzcount = _maxCount;
+    }
+
+    mgCubicSplines(n - start, _points + start, _knotvs + start, kMgCubicTan1);
+    _solved = n;
+    _clearCaches();
+
+    if (_frozen < start) {                          // 窗口前移，之前的曲线段不会再变
+        Box2d box;
+        mgCubicSplinesBox(box, start - _frozen + 1, _points + _frozen, _knotvs + _frozen);
+        _frozenBox.unionWith(box);
+        _frozen = start;
+    }
+    mgCubicSplinesBox(_extent, n - start, _points + start, _knotvs + start);
+    _extent.unionWith(_frozenBox);
+    MgBaseShape::_update();
+}
+
+const MgArcLength* MgSplines::getArcLength() const
+{
+    return _getArcLength(_knotvs);
 }
 
 float MgSplines::_hitTest(const Point2d& pt, float tol, 
                           Point2d& nearpt, Int32& segment) const
 {
-    return mgCubicSplinesHit(_count, _points, _knotvs, isClosed(), 
-        pt, tol, nearpt, segment);
+    const MgSegmentTree* tree = _knotvs ? _getSegmentTree(_knotvs) : NULL;
+    
+    if (!tree) {
+        return mgCubicSplinesHit(_count, _points, _knotvs, isClosed(), 
+            pt, tol, nearpt, segment);
+    }
+    
+    std::vector<Int32> segs;
+    std::vector<Point2d> pts;
+    
+    segment = -1;
+    tree->findSegments(Box2d(pt, 2 * tol, 2 * tol), segs);
+    pts.resize(segs.size() * 4);
+    for (size_t j = 0; j < segs.size(); j++) {
+        mgCubicSplineToBezier(_count, _points, _knotvs, segs[j], &pts[j * 4]);
+    }
+    
+    float dist = pts.empty() ? _FLT_MAX : mgNearestOnBeziers(
+        pt, (Int32)segs.size(), &pts.front(), 4, tol, nearpt, segment);
+    
+    segment = segment < 0 ? -1 : segs[segment];
+    
+    return dist;
 }
 
 bool MgSplines::_hitTestBox(const Box2d& rect) const
 {
-    if (!__super::_hitTestBox(rect))
+    const MgSegmentTree* tree = _knotvs ? _getSegmentTree(_knotvs) : NULL;
+    
+    if (!tree) {
+        if (!__super::_hitTestBox(rect))
+            return false;
+        return mgCubicSplinesIntersectBox(rect, _count, _points, _knotvs, isClosed());
+    }
+    
+    // 不调用 MgBaseLines::_hitTestBox，其绑定框层次是按直线段生成的
+    if (!MgBaseShape::_hitTestBox(rect))
         return false;
-    return mgCubicSplinesIntersectBox(rect, _count, _points, _knotvs, isClosed());
+    
+    std::vector<Int32> segs;
+    Point2d pts[4];
+    
+    tree->findSegments(rect, segs);
+    for (size_t j = 0; j < segs.size(); j++) {
+        mgCubicSplineToBezier(_count, _points, _knotvs, segs[j], pts);
+        if (mgBeziersIntersectBox(rect, 4, pts))
+            return true;
+    }
+    
+    return false;
 }
 
 bool MgSplines::_draw(GiGraphics& gs, const GiContext& ctx) const
 {
     bool ret = false;
+    std::vector<Int32> runs;
 
     if (_count == 2)
         ret = gs.drawLine(&ctx, _points[0], _points[1]);
     else if (isClosed())
         ret = gs.drawClosedSplines(&ctx, _count, _points, _knotvs);
+    else if (_findVisibleRuns(gs, ctx, _knotvs, runs)) {
+        for (size_t i = 0; i < runs.size(); i += 2) {
+            ret = gs.drawSplines(&ctx, runs[i + 1] - runs[i] + 2,
+                                 _points + runs[i], _knotvs + runs[i]) || ret;
+        }
+    }
     else
         ret = gs.drawSplines(&ctx, _count, _points, _knotvs);
 
@@ -69,43 +163,41 @@ void MgSplines::smooth(float tol)
         return;
     
     Point2d* points = new Point2d[_count];
-    Vector2d* knotvs = new Vector2d[_count];
-    UInt32* indexMap = new UInt32[_count];
+    Point2d wpts[SMOOTH_WINDOW + 1];            // 局部窗口: 上一保留点和第i点之后的几个点
+    Vector2d wvs[SMOOTH_WINDOW + 1];
     UInt32 n = 0;
-    UInt32 i, j;
+    UInt32 last = 0;                            // 上一保留点在原曲线中的序号
+    UInt32 i, j, m;
     Point2d nearpt;
     Int32 segment;
-    float dist;
     
     points[0] = _points[0];                     // 第一个点不动
-    indexMap[0] = 0;
     
     for (i = 1; i + 1 < _count; i++)            // 检查第i点能否去掉，最末点除外
     {
-        for (j = 1; i + j < _count; j++)        // 跳过第i点复制后续点到points
-            points[n + j] = _points[i + j];
-        
-        // 新曲线：indexMap[0], indexMap[1], ..., indexMap[n], i+1, i+2, ..., _count-1
-        mgCubicSplines(n + _count - i, points, knotvs, isClosed() ? kMgCubicLoop : 0);
-        dist = mgCubicSplinesHit(n + _count - i, points, knotvs, isClosed(), _points[i],
-                                 tol * 2, nearpt, segment); // 检查第i点到新曲线的距离
+        bool removed = (i - last <= MAX_SKIP);  // 连续去掉的点过多时保留，限制检查量
         
-        bool removed = true;
-        if (dist >= tol) {                      // 第i点去掉则偏了，应保留
-            removed = false;
-        }
-        else {
-            for (j = 0; j < n + _count - i; j++) {  // 切向变化超过45度时也保留点
-                UInt32 index = j > n ? i + j - n : indexMap[j];
-                if (_knotvs[index].angleTo(knotvs[j]) > _M_PI_4) {
-                    removed = false;
-                    break;
-                }
+        if (removed) {
+            // 去掉第i点后，在窗口内重新计算，首末点的切矢量取原曲线的切矢量
+            m = 0;
+            wpts[m] = points[n];
+            wvs[m++] = _knotvs[last];
+            for (j = i + 1; j < _count && m <= SMOOTH_WINDOW; j++)
+                wpts[m++] = _points[j];
+            wvs[m - 1] = _knotvs[j - 1];
+            mgCubicSplines(m, wpts, wvs, kMgCubicTan1 | kMgCubicTan2);
+            
+            for (j = last + 1; j <= i && removed; j++) {    // 已去掉的点都应在新曲线附近
+                removed = mgCubicSplinesHit(m, wpts, wvs, false, _points[j],
+                                            tol * 2, nearpt, segment) < tol;
+            }
+            for (j = 1; j + 1 < m && removed; j++) {        // 切向变化超过45度时也保留点
+                removed = _knotvs[i + j].angleTo(wvs[j]) <= _M_PI_4;
             }
         }
         if (!removed) {
             points[++n] = _points[i];
-            indexMap[n] = i;                    // 新曲线的第j点对应与原indexMap[j]点
+            last = i;
         }
     }
     if (points[n].distanceTo(_points[_count - 1]) > tol)
@@ -119,6 +211,70 @@ void MgSplines::smooth(float tol)
     }
     
     delete[] points;
+}
+
+void MgSplines::fitKnots(float tol)
+{
+    if (_count < 3)
+        return;
+    
+    const UInt32 n = _count;
+    Point2d* raw = new Point2d[n];
+    Point2d* bzpts = new Point2d[3 * n - 2];
+    Int32* indexes = new Int32[n];
+    char* isknot = new char[n];
+    Vector2d* knotvs = new Vector2d[n];
+    UInt32 i, j, m = 0;
+    Point2d pts[4], nearpt;
+    
+    for (i = 0; i < n; i++) {
+        raw[i] = _points[i];
+        isknot[i] = 0;
+    }
+    
+    // 贝塞尔曲线拟合的分段点作为初始型值点
+    Int32 segs = (mgFitBeziers(n, raw, tol, bzpts, indexes) - 1) / 3;
+    for (j = 0; (Int32)j <= segs; j++)
+        isknot[indexes[j]] = 1;
+    isknot[0] = isknot[n - 1] = 1;
+    
+    // 样条曲线与贝塞尔曲线不完全相同，在超出容差的段中加入偏离最大的点，直到都在容差内
+    for (bool inserted = true; inserted; ) {
+        for (i = 0, m = 0; i < n; i++) {
+            if (isknot[i]) {
+                _points[m] = raw[i];
+                indexes[m++] = i;
+            }
+        }
+        mgCubicSplines(m, _points, knotvs, isClosed() ? kMgCubicLoop : 0);
+        
+        inserted = false;
+        for (j = 0; j + 1 < m; j++) {
+            float maxdist = tol;
+            Int32 maxi = -1;
+            
+            mgCubicSplineToBezier(m, _points, knotvs, j, pts);
+            for (Int32 k = indexes[j] + 1; k < indexes[j + 1]; k++) {
+                mgNearestOnBezier(raw[k], pts, nearpt);
+                float dist = nearpt.distanceTo(raw[k]);
+                if (maxdist < dist) {
+                    maxdist = dist;
+                    maxi = k;
+                }
+            }
+            if (maxi >= 0) {
+                isknot[maxi] = 1;
+                inserted = true;
+            }
+        }
+    }
+    
+    _count = m;
+    update();
+    
+    delete[] raw;
+    delete[] bzpts;
+    delete[] indexes;
+    delete[] isknot;
     delete[] knotvs;
-    delete[] indexMap;
 }
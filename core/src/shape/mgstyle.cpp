@@ -0,0 +1,101 @@
+// mgstyle.cpp: 实现共享显示参数表类 MgStyleTable
+// Copyright (c) 2004-2012, Zhang Yungui
+// License: LGPL, https://github.com/rhcad/touchvg
+
+#include "mgstyle.h"
+#include <gidef.h>
+
+MgStyleTable* MgStyleTable::create()
+{
+    return new MgStyleTable();
+}
+
+MgStyleTable::MgStyleTable() : _refcount(1)
+{
+}
+
+MgStyleTable::~MgStyleTable()
+{
+}
+
+void MgStyleTable::addRef()
+{
+    giInterlockedIncrement(&_refcount);
+}
+
+void MgStyleTable::release()
+{
+    if (giInterlockedDecrement(&_refcount) == 0)
+        delete this;
+}
+
+UInt32 MgStyleTable::hashStyle(const GiContext& ctx)
+{
+    UInt32 hash = (UInt32)ctx.getLineARGB();
+
+    hash = hash * 31 + (UInt32)ctx.getFillARGB();
+    hash = hash * 31 + (UInt32)(Int32)(ctx.getLineWidth() * 100.f);
+    hash = hash * 31 + (UInt32)ctx.getLineStyle();
+    hash = hash * 4 + (ctx.isAutoScale() ? 2 : 0) + (ctx.isAutoFillColor() ? 1 : 0);
+
+    return hash;
+}
+
+UInt32 MgStyleTable::addStyle(const GiContext& ctx)
+{
+    const UInt32 hash = hashStyle(ctx);
+    std::pair<Index::iterator, Index::iterator> range(_index.equal_range(hash));
+    UInt32 style = 0;
+
+    for (Index::iterator it = range.first; it != range.second; ++it) {
+        if (_entries[it->second - 1].ctx.equals(ctx)) {
+            style = it->second;
+            break;
+        }
+    }
+    if (0 == style) {
+        Entry entry;
+
+        entry.ctx = ctx;
+        entry.refcount = 0;
+        entry.hash = hash;
+
+        if (_freeList.empty()) {
+            _entries.push_back(entry);
+            style = (UInt32)_entries.size();
+        }
+        else {
+            style = _freeList.back();
+            _freeList.pop_back();
+            _entries[style - 1] = entry;
+        }
+        _index.insert(Index::value_type(hash, style));
+    }
+    addStyleRef(style);
+
+    return style;
+}
+
+void MgStyleTable::addStyleRef(UInt32 style)
+{
+    _entries[style - 1].refcount++;
+    addRef();
+}
+
+void MgStyleTable::releaseStyle(UInt32 style)
+{
+    Entry& entry = _entries[style - 1];
+
+    if (--entry.refcount == 0) {
+        std::pair<Index::iterator, Index::iterator> range(_index.equal_range(entry.hash));
+
+        for (Index::iterator it = range.first; it != range.second; ++it) {
+            if (it->second == style) {
+                _index.erase(it);
+                break;
+            }
+        }
+        _freeList.push_back(style);
+    }
+    release();
+}
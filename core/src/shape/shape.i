@@ -1,6 +1,7 @@
 %module shape
 %{
 #include <mgshapes.h>
+#include <mgprogress.h>
 #include <mgbasicsp.h>
 #include <mgstorage.h>
 #include <mgcmddraw.h>
@@ -10,6 +11,7 @@
 %include <mgshape.h>
 %include <mgcmd.h>
 %include <mgshapes.h>
+%include <mgprogress.h>
 %include <mgbasicsp.h>
 %include <mgstorage.h>
 %include <mgcmddraw.h>
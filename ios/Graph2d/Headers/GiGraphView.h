@@ -7,6 +7,7 @@
 #import "GiZoom.h"
 
 class GiGraphIos;
+class MgDrawProgress;
 
 //! 图形视图类
 /*! \ingroup GRAPH_IOS
@@ -35,6 +36,7 @@ class GiGraphIos;
     float           _scaleBeforeDbl;        //!< 局部放大前的显示比例
     CGPoint         _centerBeforeDbl;       //!< 局部放大前的视图中心世界坐标
     float           _initialScale;          //!< 初始显示放缩比例
+    MgDrawProgress* _progress;              //!< 分步显示图形的进度
 }
 
 @property (nonatomic)          BOOL         enableZoom; //!< 是否允许放缩或平移
@@ -42,6 +44,7 @@ class GiGraphIos;
 @property (nonatomic,readonly) MgShape*     shapeAdded; //!< 待添加显示的图形
 @property (nonatomic)          BOOL         bufferEnabled;  //!< 是否允许缓冲绘图
 @property (nonatomic,readonly) float        initialScale;   //!< 初始显示放缩比例
+@property (nonatomic)          float        drawBudget;     //!< 分步显示图形时每帧的时间预算，毫秒，0表示一次显示全部图形
 
 - (CGImageRef)cachedBitmap:(BOOL)invert;    //!< 当前缓存位图，上下翻转时由调用者释放
 - (MgShapes*)getPlayShapes:(BOOL)clear;     //!< 设置临时播放的图形列表
@@ -15,7 +15,7 @@
 - (BOOL)setView:(UIView*)view;
 - (void)convertPoint:(CGPoint)pt;
 - (BOOL)getPointForPressDrag:(UIGestureRecognizer *)sender :(CGPoint*)point;
-- (GiContext*)currentContext;
+- (const GiContext*)currentContext;
 - (bool)showActions:(int)selState :(const int*)actions :(const Box2d*)selbox;
 - (IBAction)onContextAction:(id)sender;
 - (BOOL)handleSelectionTwoFingers:(UIGestureRecognizer *)sender;
@@ -188,11 +188,11 @@ static long s_cmdRef = 0;
     return valid;
 }
 
-- (GiContext*)currentContext
+- (const GiContext*)currentContext
 {
     MgShape* shape = NULL;
     mgGetCommandManager()->getSelection(_mgview, 1, &shape, false);
-    return shape ? shape->context() : _mgview->context();
+    return shape ? shape->contextc() : _mgview->context();
 }
 
 + (void)hideContextActions
@@ -329,7 +329,9 @@ static long s_cmdRef = 0;
     
     if (n > 0 && mgGetCommandManager()->getSelection(_mgview, n, (MgShape**)&shapes.front(), true) == n) {
         for (UInt32 i = 0; i < n; i++) {
-            shapes[i]->context()->setLineWidth(w, true);
+            GiContext ctx(*shapes[i]->contextc());
+            ctx.setLineWidth(w, true);
+            shapes[i]->setContext(ctx);
         }
         _motion->view->redraw(false);
     }
@@ -348,7 +350,9 @@ static long s_cmdRef = 0;
     
     if (n > 0 && mgGetCommandManager()->getSelection(_mgview, n, (MgShape**)&shapes.front(), true) == n) {
         for (UInt32 i = 0; i < n; i++) {
-            shapes[i]->context()->setLineColor(c);
+            GiContext ctx(*shapes[i]->contextc());
+            ctx.setLineColor(c);
+            shapes[i]->setContext(ctx);
         }
         _motion->view->redraw(false);
     }
@@ -367,7 +371,9 @@ static long s_cmdRef = 0;
     
     if (n > 0 && mgGetCommandManager()->getSelection(_mgview, n, (MgShape**)&shapes.front(), true) == n) {
         for (UInt32 i = 0; i < n; i++) {
-            shapes[i]->context()->setFillColor(c);
+            GiContext ctx(*shapes[i]->contextc());
+            ctx.setFillColor(c);
+            shapes[i]->setContext(ctx);
         }
         _motion->view->redraw(false);
     }
@@ -386,7 +392,9 @@ static long s_cmdRef = 0;
     
     if (n > 0 && mgGetCommandManager()->getSelection(_mgview, n, (MgShape**)&shapes.front(), true) == n) {
         for (UInt32 i = 0; i < n; i++) {
-            shapes[i]->context()->setLineStyle((GiLineStyle)style);
+            GiContext ctx(*shapes[i]->contextc());
+            ctx.setLineStyle((GiLineStyle)style);
+            shapes[i]->setContext(ctx);
         }
         _motion->view->redraw(false);
     }
@@ -405,7 +413,9 @@ static long s_cmdRef = 0;
     
     if (n > 0 && mgGetCommandManager()->getSelection(_mgview, n, (MgShape**)&shapes.front(), true) == n) {
         for (UInt32 i = 0; i < n; i++) {
-            shapes[i]->context()->setAutoFillColor(value);
+            GiContext ctx(*shapes[i]->contextc());
+            ctx.setAutoFillColor(value);
+            shapes[i]->setContext(ctx);
         }
         _motion->view->redraw(false);
     }
@@ -5,6 +5,8 @@
 #import "GiGraphView.h"
 #include <iosgraph.h>
 #include <mgshapes.h>
+#include <mgprogress.h>
+#include <gitiles.h>
 
 @interface GiGraphView(Zooming)
 
@@ -22,6 +24,14 @@ GiColor giFromUIColor(UIColor *color)
     return color ? giFromCGColor(color.CGColor) : GiColor::Invalid();
 }
 
+//! 显示平移后露出区域的辅助类
+struct GiViewTileDrawer : public GiTileDrawer
+{
+    GiGraphView* view;
+    GiViewTileDrawer(GiGraphView* v) : view(v) {}
+    virtual int drawTile(GiGraphics& gs) { return [view draw:&gs] ? 1 : 0; }
+};
+
 static void onShapesLocked(MgShapes* sp, void* obj, bool locked)
 {
     GiGraphView* view = (GiGraphView*)obj;
@@ -74,6 +84,10 @@ static void onShapesLocked(MgShapes* sp, void* obj, bool locked)
         delete _graph;
         _graph = NULL;
     }
+    if (_progress) {
+        delete _progress;
+        _progress = NULL;
+    }
     [super dealloc];
 }
 
@@ -84,6 +98,10 @@ static void onShapesLocked(MgShapes* sp, void* obj, bool locked)
     
     if (!_graph) {
         _graph = new GiGraphIos();
+        _graph->gs.setIncrementalPan(true);     // 平移时只显示露出的区域
+    }
+    if (!_progress) {
+        _progress = new MgDrawProgress(0);
     }
 
     _graph->xf.setWndSize(CGRectGetWidth(self.bounds), CGRectGetHeight(self.bounds));
@@ -120,6 +138,7 @@ static void onShapesLocked(MgShapes* sp, void* obj, bool locked)
     bool buffered = (_buffered & 0x10) && ((_buffered & 1) || !cv.hasCachedBitmap());
     bool nextDraw = false;
     MgShape* tmpAdded = _shapeAdded;
+    GiViewTileDrawer drawer(self);
     
     _graph->xf.setWndSize(CGRectGetWidth(self.bounds), CGRectGetHeight(self.bounds));
     if (_shapes && !_scaleReaded) {
@@ -132,7 +151,8 @@ static void onShapesLocked(MgShapes* sp, void* obj, bool locked)
     if (cv.beginPaint(UIGraphicsGetCurrentContext(),    // 在当前画布上准备绘图
                       !!_zooming, buffered))        // iPad3上不用缓冲更快
     {
-        if (!cv.drawCachedBitmap()) {               // 显示上次保存的缓冲图
+        if (!gs.drawCachedBitmap(&drawer)) {        // 显示上次保存的缓冲图，只平移时只显示露出的区域
+            _progress->restart();
             if ([self draw:&gs]) {                  // 不行则重新显示所有图形
                 if (!_zooming)                      // 动态放缩时不保存显示内容
                     cv.saveCachedBitmap();          // 保存显示缓冲图，下次就不重新显示图形
@@ -142,12 +162,18 @@ static void onShapesLocked(MgShapes* sp, void* obj, bool locked)
                 nextDraw = true;
             }
         }
+        else if (_progress->isDrawing()) {          // 在缓冲图上继续分步显示
+            if ([self draw:&gs]) {
+                cv.saveCachedBitmap();
+            }
+        }
         else if (_shapeAdded) {                     // 在缓冲图上显示新的图形
             _shapeAdded->draw(gs);
             cv.saveCachedBitmap();                  // 更新缓冲图
             tmpAdded = NULL;
         }
         
+        nextDraw = nextDraw || _progress->isDrawing();  // 分步显示未完成则下一帧继续
         nextDraw = ![self dynDraw:&gs] || nextDraw; // 显示动态临时图形
         
         cv.endPaint();                              // 显示完成后贴到视图画布上
@@ -164,7 +190,7 @@ static void onShapesLocked(MgShapes* sp, void* obj, bool locked)
 
 - (void)shapeAdded:(MgShape*)shape
 {
-    if (_shapeAdded || !shape) {
+    if (_shapeAdded || !shape || _progress->isDrawing()) {
         _buffered |= 1;
         [self regen];
     }
@@ -187,7 +213,12 @@ static void onShapesLocked(MgShapes* sp, void* obj, bool locked)
         }
     }
     else if (_shapes) {
-        _shapes->draw(*gs);
+        if (_progress->getBudgetMs() > 0 && !_zooming && (_buffered & 0x10)) {
+            _shapes->drawPart(*gs, *_progress);     // 在时间预算内显示部分图形
+        }
+        else {
+            _shapes->draw(*gs);
+        }
     }
     
     return ret;
@@ -255,6 +286,7 @@ static void onShapesLocked(MgShapes* sp, void* obj, bool locked)
 }
 
 - (void)regen {
+    _progress->restart();
     _graph->gs.clearCachedBitmap();
     _buffered |= 1;
     [self setNeedsDisplay];
@@ -266,6 +298,15 @@ static void onShapesLocked(MgShapes* sp, void* obj, bool locked)
     [self setNeedsDisplay];
 }
 
+- (float)drawBudget {
+    return _progress->getBudgetMs();
+}
+
+- (void)setDrawBudget:(float)ms {
+    _progress->setBudget(ms);
+    [self regen];
+}
+
 - (BOOL)bufferEnabled {
     return (_buffered & 0x10) != 0;
 }
@@ -371,16 +412,29 @@ static void onShapesLocked(MgShapes* sp, void* obj, bool locked)
     if (sender.state == UIGestureRecognizerStateBegan) {
         [self saveZoomScale:point];
         _zooming = YES;
+        if (_progress->isDrawing()) {           // 分步显示未完成的缓冲图不能平移显示
+            [self regen];
+        }
     }
     else {
         _zooming = (sender.state == UIGestureRecognizerStateChanged);
+        if (!_zooming) {                        // 动态放缩时平移的缓冲图是快速显示的
+            [self regen];
+        }
     }
     
     if (_zooming) {
         Point2d at (_firstPoint.x, _firstPoint.y );
+        float dx = point.x - _firstPoint.x;
+        float dy = point.y - _firstPoint.y;
+        
+        if (scale == 1) {                       // 只平移时取整，以便平移缓冲图
+            dx = floorf(dx + 0.5f);
+            dy = floorf(dy + 0.5f);
+        }
         _graph->xf.zoom(Point2d(_lastCenterW.x, _lastCenterW.y), _lastViewScale);   // 先恢复
         _graph->xf.zoomByFactor(scale - 1, &at);                        // 以起始点为中心放缩显示
-        _graph->xf.zoomPan(point.x - _firstPoint.x, point.y - _firstPoint.y);   // 平移到当前点
+        _graph->xf.zoomPan(dx, dy);                                     // 平移到当前点
     }
     
     if ([_drawingDelegate respondsToSelector:@selector(afterZoomed:)]) {